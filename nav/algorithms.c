@@ -2,72 +2,143 @@
  #include "utils.h"
  #include <stdio.h>
  #include <stdlib.h>
+ #include <string.h>
  #include <float.h>
  #include <limits.h>
+ #include <math.h>
  
  #define INFINITY_VAL DBL_MAX
  
- //Internal Priority Queue 
- typedef struct PQNode { 
-     int node_id; 
-     double priority; 
-     struct PQNode* next;
- } PQNode;
-
- typedef struct { 
-     PQNode* head; 
- } PriorityQueue;
- 
- static PriorityQueue* pq_create() {
-     return calloc(1, sizeof(PriorityQueue));
- }
-
- static void pq_destroy(PriorityQueue* pq) {
-     PQNode* current = pq->head;
-     while (current) {
-         PQNode* temp = current;
-         current = current->next;
-         free(temp);
-     }
-     free(pq);
- }
-
- static bool pq_is_empty(const PriorityQueue* pq) { return !pq || !pq->head; }
-
- static void pq_insert(PriorityQueue* pq, int node_id, double priority) {
-     PQNode* new_node = malloc(sizeof(PQNode));
-     new_node->node_id = node_id; 
-     new_node->priority = priority;
-     if (!pq->head || priority < pq->head->priority) {
-         new_node->next = pq->head; pq->head = new_node;
-     } else {
-         PQNode* current = pq->head;
-         while (current->next && current->next->priority <= priority) current = current->next;
-         new_node->next = current->next; 
-         current->next = new_node;
-     }
- }
-
- static int pq_extract_min(PriorityQueue* pq) {
-     if (pq_is_empty(pq)) return -1;
-     PQNode* min_node = pq->head;
-     int node_id = min_node->node_id;
-     pq->head = min_node->next;
-     free(min_node);
-     return node_id;
- }
- 
- static int* reconstruct_path(const int* predecessors, int start_id, int end_id, int* path_length) {
+ // Search Sides
+ static bool side_reserve(SearchSide* side, int capacity) {
+     if (capacity <= side->capacity) return true;
+ 
+     unsigned int* visited = realloc(side->visited_stamp, capacity * sizeof(unsigned int));
+     if (visited) side->visited_stamp = visited;
+     unsigned int* settled = realloc(side->settled_stamp, capacity * sizeof(unsigned int));
+     if (settled) side->settled_stamp = settled;
+     double* distance = realloc(side->distance, capacity * sizeof(double));
+     if (distance) side->distance = distance;
+     int* predecessor = realloc(side->predecessor, capacity * sizeof(int));
+     if (predecessor) side->predecessor = predecessor;
+ 
+     if (!visited || !settled || !distance || !predecessor || !heap_reserve(&side->heap, capacity)) {
+         fprintf(stderr, "[Algorithm Error] search_workspace_reserve: Failed to grow workspace to %d nodes\n", capacity);
+         return false;
+     }
+ 
+     // Stamp 0 is never a live generation, so new slots start out untouched
+     memset(side->visited_stamp + side->capacity, 0, (capacity - side->capacity) * sizeof(unsigned int));
+     memset(side->settled_stamp + side->capacity, 0, (capacity - side->capacity) * sizeof(unsigned int));
+     side->capacity = capacity;
+     return true;
+ }
+ 
+ static void side_free(SearchSide* side) {
+     free(side->visited_stamp);
+     free(side->settled_stamp);
+     free(side->distance);
+     free(side->predecessor);
+     heap_free(&side->heap);
+ }
+ 
+ // Search Workspace
+ SearchWorkspace* search_workspace_create(int capacity) {
+     SearchWorkspace* ws = calloc(1, sizeof(SearchWorkspace));
+     if (!ws) {
+         fprintf(stderr, "[Algorithm Error] search_workspace_create: Failed to allocate workspace\n");
+         return NULL;
+     }
+     ws->generation = 1;
+     if (!search_workspace_reserve(ws, capacity)) {
+         search_workspace_destroy(ws);
+         return NULL;
+     }
+     return ws;
+ }
+ 
+ void search_workspace_destroy(SearchWorkspace* ws) {
+     if (!ws) return;
+     side_free(&ws->forward);
+     side_free(&ws->backward);
+     free(ws);
+ }
+ 
+ bool search_workspace_reserve(SearchWorkspace* ws, int capacity) {
+     if (!ws) return false;
+     if (capacity <= ws->capacity) return true;
+     if (!side_reserve(&ws->forward, capacity)) return false;
+     if (ws->backward.capacity > 0 && !side_reserve(&ws->backward, capacity)) return false;
+     ws->capacity = capacity;
+     return true;
+ }
+ 
+ void search_workspace_set_path_buffer(SearchWorkspace* ws, int* buffer, int capacity) {
+     if (!ws) return;
+     ws->path_buffer = buffer;
+     ws->path_buffer_capacity = buffer ? capacity : 0;
+ }
+ 
+ // Invalidates every node's state in O(1) by advancing the generation
+ static void workspace_next_generation(SearchWorkspace* ws) {
+     ws->generation++;
+     if (ws->generation == 0) {
+         SearchSide* sides[2] = { &ws->forward, &ws->backward };
+         for (int i = 0; i < 2; i++) {
+             if (sides[i]->capacity == 0) continue;
+             memset(sides[i]->visited_stamp, 0, sides[i]->capacity * sizeof(unsigned int));
+             memset(sides[i]->settled_stamp, 0, sides[i]->capacity * sizeof(unsigned int));
+         }
+         ws->generation = 1;
+     }
+     heap_clear(&ws->forward.heap);
+     heap_clear(&ws->backward.heap);
+     ws->nodes_settled = 0;
+ }
+ 
+ bool search_workspace_begin(SearchWorkspace* ws, int num_nodes, bool bidirectional) {
+     if (!search_workspace_reserve(ws, num_nodes)) return false;
+     if (bidirectional && !side_reserve(&ws->backward, ws->capacity)) return false;
+     workspace_next_generation(ws);
+     return true;
+ }
+ 
+ static bool prepare_search(const Graph* graph, SearchWorkspace* ws, int start_id, int end_id,
+                            bool bidirectional, const char* caller) {
+     if (!ws) {
+         fprintf(stderr, "[Algorithm Error] %s: Workspace is NULL\n", caller);
+         return false;
+     }
+     if (!is_valid_node(graph, start_id) || !is_valid_node(graph, end_id)) return false;
+     if (!is_graph_frozen(graph)) {
+         fprintf(stderr, "[Algorithm Error] %s: Graph is not frozen (call graph_freeze)\n", caller);
+         return false;
+     }
+     return search_workspace_begin(ws, get_node_count(graph), bidirectional);
+ }
+ 
+ // Path output goes to the workspace's path buffer when one is set and large enough
+ static int* allocate_path(const SearchWorkspace* ws, int len, PathResult* result) {
+     if (ws->path_buffer && len <= ws->path_buffer_capacity) {
+         result->owns_path = false;
+         return ws->path_buffer;
+     }
+     int* path = malloc(len * sizeof(int));
+     result->owns_path = path != NULL;
+     return path;
+ }
+ 
+ static void reconstruct_path(const SearchWorkspace* ws, int start_id, int end_id, PathResult* result) {
+     const int* predecessors = ws->forward.predecessor;
      int len = 0;
      for (int at = end_id; at != -1; at = predecessors[at]) len++;
  
-     int* path = malloc(len * sizeof(int));
+     int* path = allocate_path(ws, len, result);
      if (!path) {
-         *path_length = 0;
-         return NULL;
+         result->path_length = 0;
+         return;
      }
  
-     *path_length = len;
      int current = end_id;
      for (int i = len - 1; i >= 0; i--) {
          path[i] = current;
@@ -75,133 +146,435 @@
      }
  
      if (len > 0 && path[0] != start_id) {
-         free(path);
-         *path_length = 0;
-         return NULL;
+         if (result->owns_path) free(path);
+         result->owns_path = false;
+         result->path_length = 0;
+         return;
      }
      
-     return path;
+     result->path = path;
+     result->path_length = len;
  }
  
- // A* HEURISTIC FUNCTION
- static double heuristic(const Graph* graph, int node_id, int end_id) {
-     const Node* current = get_node(graph, node_id);
-     const Node* end = get_node(graph, end_id);
+ static void finish_result(const SearchWorkspace* ws, int start_id, int end_id, PathResult* result) {
+     if (!side_reached(&ws->forward, ws->generation, end_id)) return;
  
-     if (!current || !end) {
-         return 0.0;
+     reconstruct_path(ws, start_id, end_id, result);
+     if (result->path) {
+         result->total_distance = ws->forward.distance[end_id];
+         result->found = true;
      }
-
-     return haversine_distance(current->latitude, current->longitude,end->latitude, end->longitude);
+ }
+ 
+ // A* HEURISTIC FUNCTION
+ // Straight-line chord through the earth between the precomputed unit
+ // vectors: a few multiplies and one sqrt instead of haversine's trig. The
+ // chord is never longer than the great-circle arc, so it stays admissible.
+ // Ids come from validated endpoints and CSR targets, so are not rechecked.
+ static inline double heuristic(const Graph* graph, int node_id, int end_id) {
+     const double* a = &graph->unit_vectors[3 * node_id];
+     const double* b = &graph->unit_vectors[3 * end_id];
+     double dx = a[0] - b[0];
+     double dy = a[1] - b[1];
+     double dz = a[2] - b[2];
+     return EARTH_RADIUS_KM * sqrt(dx * dx + dy * dy + dz * dz);
  }
  
  // Dijkstra 
- PathResult dijkstra_shortest_path(const Graph* graph, int start_id, int end_id) {
+ PathResult dijkstra_shortest_path_ws(const Graph* graph, SearchWorkspace* ws, int start_id, int end_id) {
      PathResult result = { .found = false };
-     int num_nodes = get_node_count(graph);
-     double* distances = calloc(num_nodes, sizeof(double));
-     int* predecessors = calloc(num_nodes, sizeof(int));
-     PriorityQueue* pq = pq_create();
+     if (!prepare_search(graph, ws, start_id, end_id, false, "dijkstra_shortest_path")) return result;
  
-     for (int i = 0; i < num_nodes; i++) {
-         distances[i] = INFINITY_VAL;
-         predecessors[i] = -1;
-     }
+     SearchSide* fwd = &ws->forward;
+     unsigned int gen = ws->generation;
+     double* distances = fwd->distance;
+     int* predecessors = fwd->predecessor;
+     IndexedHeap* pq = &fwd->heap;
+ 
+     side_touch(fwd, gen, start_id);
      distances[start_id] = 0.0;
-     pq_insert(pq, start_id, 0.0);
+     heap_push_or_decrease(pq, start_id, 0.0);
  
-     while (!pq_is_empty(pq)) {
-         int current_id = pq_extract_min(pq);
+     while (!heap_is_empty(pq)) {
+         int current_id = heap_pop_min(pq, NULL);
+         side_settle(ws, fwd, current_id);
          if (current_id == end_id) break;
-         const Edge* edge = get_edges(graph, current_id);
-         while (edge) {
-             double new_dist = distances[current_id] + edge->weight;
-             if (new_dist < distances[edge->destination_id]) {
-                 distances[edge->destination_id] = new_dist;
-                 predecessors[edge->destination_id] = current_id;
-                 pq_insert(pq, edge->destination_id, new_dist);
+         int edge_end = graph->edge_offsets[current_id + 1];
+         for (int e = graph->edge_offsets[current_id]; e < edge_end; e++) {
+             int neighbor_id = graph->edge_targets[e];
+             if (side_is_settled(fwd, gen, neighbor_id)) continue;
+             side_touch(fwd, gen, neighbor_id);
+             double new_dist = distances[current_id] + graph->edge_weights[e];
+             if (new_dist < distances[neighbor_id]) {
+                 distances[neighbor_id] = new_dist;
+                 predecessors[neighbor_id] = current_id;
+                 heap_push_or_decrease(pq, neighbor_id, new_dist);
              }
-             edge = edge->next;
          }
      }
  
-     if (distances[end_id] != INFINITY_VAL) {
-         result.path = reconstruct_path(predecessors, start_id, end_id, &result.path_length);
-         
-         if (result.path) {
-             result.total_distance = distances[end_id];
-             result.found = true;
-         }
-     }
- 
-     free(distances);
-     free(predecessors);
-     pq_destroy(pq);
+     finish_result(ws, start_id, end_id, &result);
      return result;
  }
  
  // A*
- PathResult a_star_shortest_path(const Graph* graph, int start_id, int end_id) {
-     PathResult result = { .found = false };
-     int num_nodes = get_node_count(graph);
+ static double chord_heuristic(const void* context, int node_id, int end_id) {
+     return heuristic((const Graph*)context, node_id, end_id);
+ }
  
-     double* g_scores = calloc(num_nodes, sizeof(double));
-     double* f_scores = calloc(num_nodes, sizeof(double));
-     int* predecessors = calloc(num_nodes, sizeof(int));
-     PriorityQueue* pq = pq_create();
+ // Inlined into both entry points so the default heuristic is not an indirect call
+ static inline PathResult a_star_search(const Graph* graph, SearchWorkspace* ws, int start_id, int end_id,
+                                        HeuristicFn estimate, const void* context) {
+     PathResult result = { .found = false };
+     if (!prepare_search(graph, ws, start_id, end_id, false, "a_star_shortest_path")) return result;
  
-     for (int i = 0; i < num_nodes; i++) {
-         g_scores[i] = INFINITY_VAL;    //actual cost from starting
-         f_scores[i] = INFINITY_VAL;    //guess + heuristic for guiding a* in a straight line
-         predecessors[i] = -1;
-     }
+     SearchSide* fwd = &ws->forward;
+     unsigned int gen = ws->generation;
+     double* g_scores = fwd->distance;    //actual cost from starting
+     int* predecessors = fwd->predecessor;
+     IndexedHeap* pq = &fwd->heap;
  
+     // f = g + heuristic guides A* towards the target; it lives only as the heap key
+     side_touch(fwd, gen, start_id);
      g_scores[start_id] = 0.0;
-     f_scores[start_id] = heuristic(graph, start_id, end_id);
-     
-     pq_insert(pq, start_id, f_scores[start_id]);
+     heap_push_or_decrease(pq, start_id, estimate(context, start_id, end_id));
  
-     while (!pq_is_empty(pq)) {
-         int current_id = pq_extract_min(pq);
+     while (!heap_is_empty(pq)) {
+         int current_id = heap_pop_min(pq, NULL);
+         side_settle(ws, fwd, current_id);
          if (current_id == end_id) break;
  
-         const Edge* edge = get_edges(graph, current_id);
-         while (edge) {
-             int neighbor_id = edge->destination_id;
-             double tentative_g_score = g_scores[current_id] + edge->weight;
+         int edge_end = graph->edge_offsets[current_id + 1];
+         for (int e = graph->edge_offsets[current_id]; e < edge_end; e++) {
+             int neighbor_id = graph->edge_targets[e];
+             if (side_is_settled(fwd, gen, neighbor_id)) continue;
+             side_touch(fwd, gen, neighbor_id);
+             double tentative_g_score = g_scores[current_id] + graph->edge_weights[e];
  
              if (tentative_g_score < g_scores[neighbor_id]) {
                  predecessors[neighbor_id] = current_id;
                  g_scores[neighbor_id] = tentative_g_score;
-                 f_scores[neighbor_id] = tentative_g_score + heuristic(graph, neighbor_id, end_id);
-                 pq_insert(pq, neighbor_id, f_scores[neighbor_id]);
+                 heap_push_or_decrease(pq, neighbor_id, tentative_g_score + estimate(context, neighbor_id, end_id));
+             }
+         }
+     }
+ 
+     finish_result(ws, start_id, end_id, &result);
+     return result;
+ }
+ 
+ PathResult a_star_shortest_path_with(const Graph* graph, SearchWorkspace* ws, int start_id, int end_id,
+                                      HeuristicFn estimate, const void* context) {
+     return a_star_search(graph, ws, start_id, end_id, estimate, context);
+ }
+ 
+ PathResult a_star_shortest_path_ws(const Graph* graph, SearchWorkspace* ws, int start_id, int end_id) {
+     return a_star_search(graph, ws, start_id, end_id, chord_heuristic, graph);
+ }
+ 
+ // Full single-source Dijkstra over out-edges (in-edges when reverse is set)
+ int dijkstra_settle_all_ws(const Graph* graph, SearchWorkspace* ws, int source_id, bool reverse, int* order) {
+     if (!ws || !is_valid_node(graph, source_id)) return 0;
+     if (!is_graph_frozen(graph)) {
+         fprintf(stderr, "[Algorithm Error] dijkstra_settle_all: Graph is not frozen (call graph_freeze)\n");
+         return 0;
+     }
+     if (!search_workspace_begin(ws, get_node_count(graph), false)) return 0;
+ 
+     const int* offsets = reverse ? graph->rev_edge_offsets : graph->edge_offsets;
+     const int* neighbors = reverse ? graph->rev_edge_sources : graph->edge_targets;
+     const double* weights = reverse ? graph->rev_edge_weights : graph->edge_weights;
+     SearchSide* side = &ws->forward;
+     unsigned int gen = ws->generation;
+ 
+     side_touch(side, gen, source_id);
+     side->distance[source_id] = 0.0;
+     heap_push_or_decrease(&side->heap, source_id, 0.0);
+ 
+     int settled = 0;
+     while (!heap_is_empty(&side->heap)) {
+         int current_id = heap_pop_min(&side->heap, NULL);
+         side_settle(ws, side, current_id);
+         if (order) order[settled] = current_id;
+         settled++;
+         for (int e = offsets[current_id]; e < offsets[current_id + 1]; e++) {
+             int neighbor_id = neighbors[e];
+             if (side_is_settled(side, gen, neighbor_id)) continue;
+             side_touch(side, gen, neighbor_id);
+             double new_dist = side->distance[current_id] + weights[e];
+             if (new_dist < side->distance[neighbor_id]) {
+                 side->distance[neighbor_id] = new_dist;
+                 side->predecessor[neighbor_id] = current_id;
+                 heap_push_or_decrease(&side->heap, neighbor_id, new_dist);
              }
-             edge = edge->next;
          }
      }
+     return settled;
+ }
+ 
+ // Incremental tree repair
+ 
+ static inline void repair_relax(IndexedHeap* pq, double* distances, int* predecessors, int from_id, int to_id, double weight) {
+     double new_dist = distances[from_id] + weight;
+     if (new_dist < distances[to_id]) {
+         distances[to_id] = new_dist;
+         predecessors[to_id] = from_id;
+         heap_push_or_decrease(pq, to_id, new_dist);
+     }
+ }
+ 
+ int dijkstra_repair_tree_ws(const Graph* graph, SearchWorkspace* ws, int source_id, double* distances, int* predecessors,
+                             const GraphChange* changes, int num_changes) {
+     if (!ws || !distances || !predecessors || !is_valid_node(graph, source_id) || num_changes < 0
+         || (num_changes > 0 && !changes)) {
+         fprintf(stderr, "[Algorithm Error] dijkstra_repair_tree: Invalid tree, source or changes\n");
+         return -1;
+     }
+     if (!is_graph_frozen(graph)) {
+         fprintf(stderr, "[Algorithm Error] dijkstra_repair_tree: Graph is not frozen (call graph_freeze)\n");
+         return -1;
+     }
+     if (!search_workspace_begin(ws, get_node_count(graph), false)) return -1;
+ 
+     SearchSide* side = &ws->forward;
+     unsigned int gen = ws->generation;
+     unsigned int* affected_stamp = side->visited_stamp;
+     int* affected = side->predecessor;   // Scratch list; the workspace's own labels are unused here
+     IndexedHeap* pq = &side->heap;
+     int num_affected = 0;
+ 
+     // A tree edge that no longer supports its child's label cuts off the child's subtree
+     for (int c = 0; c < num_changes; c++) {
+         int u = changes[c].source_id;
+         int v = changes[c].destination_id;
+         if (predecessors[v] != u || affected_stamp[v] == gen) continue;
+         double weight = DBL_MAX;
+         for (int e = graph->edge_offsets[u]; e < graph->edge_offsets[u + 1]; e++) {
+             if (graph->edge_targets[e] == v && graph->edge_weights[e] < weight) weight = graph->edge_weights[e];
+         }
+         if (distances[u] + weight <= distances[v]) continue;
+         affected_stamp[v] = gen;
+         affected[num_affected++] = v;
+     }
+     for (int i = 0; i < num_affected; i++) {
+         int node_id = affected[i];
+         for (int e = graph->edge_offsets[node_id]; e < graph->edge_offsets[node_id + 1]; e++) {
+             int child_id = graph->edge_targets[e];
+             if (predecessors[child_id] == node_id && affected_stamp[child_id] != gen) {
+                 affected_stamp[child_id] = gen;
+                 affected[num_affected++] = child_id;
+             }
+         }
+     }
+     for (int i = 0; i < num_affected; i++) {
+         distances[affected[i]] = DBL_MAX;
+         predecessors[affected[i]] = -1;
+     }
  
-     if (g_scores[end_id] != INFINITY_VAL) {
-         result.path = reconstruct_path(predecessors, start_id, end_id, &result.path_length);
-         
+     // Cut-off nodes restart from their best in-edge out of the intact tree,
+     // and edges that got cheaper may shorten paths below them
+     for (int i = 0; i < num_affected; i++) {
+         int node_id = affected[i];
+         for (int e = graph->rev_edge_offsets[node_id]; e < graph->rev_edge_offsets[node_id + 1]; e++) {
+             int from_id = graph->rev_edge_sources[e];
+             if (affected_stamp[from_id] == gen || distances[from_id] == DBL_MAX) continue;
+             repair_relax(pq, distances, predecessors, from_id, node_id, graph->rev_edge_weights[e]);
+         }
+     }
+     for (int c = 0; c < num_changes; c++) {
+         int u = changes[c].source_id;
+         if (distances[u] == DBL_MAX) continue;
+         for (int e = graph->edge_offsets[u]; e < graph->edge_offsets[u + 1]; e++) {
+             if (graph->edge_targets[e] == changes[c].destination_id) {
+                 repair_relax(pq, distances, predecessors, u, graph->edge_targets[e], graph->edge_weights[e]);
+             }
+         }
+     }
+ 
+     // Dijkstra from those seeds over the region whose labels change
+     int relabelled = 0;
+     while (!heap_is_empty(pq)) {
+         int current_id = heap_pop_min(pq, NULL);
+         relabelled++;
+         for (int e = graph->edge_offsets[current_id]; e < graph->edge_offsets[current_id + 1]; e++) {
+             repair_relax(pq, distances, predecessors, current_id, graph->edge_targets[e], graph->edge_weights[e]);
+         }
+     }
+     // Cut-off nodes nothing reached again are now unreachable, which is a new label too
+     for (int i = 0; i < num_affected; i++) {
+         if (distances[affected[i]] == DBL_MAX) relabelled++;
+     }
+     return relabelled;
+ }
+ 
+ // Bidirectional search
+ //
+ // Forward keys are d_f(v) + p(v) and backward keys d_b(v) - p(v) with the
+ // averaged potential p(v) = (h(v, end) - h(start, v)) / 2. The potential is
+ // consistent in both directions, so the search may stop as soon as the two
+ // smallest keys sum to at least the best meeting distance found. With p = 0
+ // this is plain bidirectional Dijkstra.
+ static inline double bidirectional_potential(const Graph* graph, int node_id, int start_id, int end_id) {
+     return 0.5 * (heuristic(graph, node_id, end_id) - heuristic(graph, start_id, node_id));
+ }
+ 
+ static void reconstruct_bidirectional_path(const SearchWorkspace* ws, int meeting_id, PathResult* result) {
+     const int* predecessors = ws->forward.predecessor;
+     const int* successors = ws->backward.predecessor;
+     int forward_len = 0, backward_len = 0;
+     for (int at = meeting_id; at != -1; at = predecessors[at]) forward_len++;
+     for (int at = successors[meeting_id]; at != -1; at = successors[at]) backward_len++;
+ 
+     int len = forward_len + backward_len;
+     int* path = allocate_path(ws, len, result);
+     if (!path) return;
+ 
+     int current = meeting_id;
+     for (int i = forward_len - 1; i >= 0; i--) {
+         path[i] = current;
+         current = predecessors[current];
+     }
+     current = successors[meeting_id];
+     for (int i = forward_len; i < len; i++) {
+         path[i] = current;
+         current = successors[current];
+     }
+     result->path = path;
+     result->path_length = len;
+ }
+ 
+ static PathResult bidirectional_search(const Graph* graph, SearchWorkspace* ws, int start_id, int end_id,
+                                        bool use_potential, const char* caller) {
+     PathResult result = { .found = false };
+     if (!prepare_search(graph, ws, start_id, end_id, true, caller)) return result;
+ 
+     SearchSide* fwd = &ws->forward;
+     SearchSide* bwd = &ws->backward;
+     unsigned int gen = ws->generation;
+ 
+     side_touch(fwd, gen, start_id);
+     fwd->distance[start_id] = 0.0;
+     side_touch(bwd, gen, end_id);
+     bwd->distance[end_id] = 0.0;
+ 
+     double start_potential = use_potential ? bidirectional_potential(graph, start_id, start_id, end_id) : 0.0;
+     double end_potential = use_potential ? bidirectional_potential(graph, end_id, start_id, end_id) : 0.0;
+     heap_push_or_decrease(&fwd->heap, start_id, start_potential);
+     heap_push_or_decrease(&bwd->heap, end_id, -end_potential);
+ 
+     double best = (start_id == end_id) ? 0.0 : INFINITY_VAL;
+     int meeting_id = (start_id == end_id) ? start_id : -1;
+ 
+     while (!heap_is_empty(&fwd->heap) && !heap_is_empty(&bwd->heap)) {
+         double top_forward = heap_min_key(&fwd->heap);
+         double top_backward = heap_min_key(&bwd->heap);
+         if (top_forward + top_backward >= best) break;
+ 
+         // Expand the side whose frontier is closer
+         bool forward_step = top_forward <= top_backward;
+         SearchSide* side = forward_step ? fwd : bwd;
+         SearchSide* other = forward_step ? bwd : fwd;
+         const int* offsets = forward_step ? graph->edge_offsets : graph->rev_edge_offsets;
+         const int* neighbors = forward_step ? graph->edge_targets : graph->rev_edge_sources;
+         const double* weights = forward_step ? graph->edge_weights : graph->rev_edge_weights;
+         double sign = forward_step ? 1.0 : -1.0;
+ 
+         int current_id = heap_pop_min(&side->heap, NULL);
+         side_settle(ws, side, current_id);
+ 
+         int edge_end = offsets[current_id + 1];
+         for (int e = offsets[current_id]; e < edge_end; e++) {
+             int neighbor_id = neighbors[e];
+             if (side_is_settled(side, gen, neighbor_id)) continue;
+             side_touch(side, gen, neighbor_id);
+             double new_dist = side->distance[current_id] + weights[e];
+             if (new_dist < side->distance[neighbor_id]) {
+                 side->distance[neighbor_id] = new_dist;
+                 side->predecessor[neighbor_id] = current_id;
+                 double key = new_dist;
+                 if (use_potential) key += sign * bidirectional_potential(graph, neighbor_id, start_id, end_id);
+                 heap_push_or_decrease(&side->heap, neighbor_id, key);
+             }
+             if (side_reached(other, gen, neighbor_id) && side->distance[neighbor_id] + other->distance[neighbor_id] < best) {
+                 best = side->distance[neighbor_id] + other->distance[neighbor_id];
+                 meeting_id = neighbor_id;
+             }
+         }
+     }
+ 
+     if (meeting_id != -1) {
+         reconstruct_bidirectional_path(ws, meeting_id, &result);
          if (result.path) {
-             result.total_distance = g_scores[end_id];
+             result.total_distance = best;
              result.found = true;
          }
      }
+     return result;
+ }
+ 
+ PathResult bidirectional_dijkstra_shortest_path_ws(const Graph* graph, SearchWorkspace* ws, int start_id, int end_id) {
+     return bidirectional_search(graph, ws, start_id, end_id, false, "bidirectional_dijkstra_shortest_path");
+ }
+ 
+ PathResult bidirectional_a_star_shortest_path_ws(const Graph* graph, SearchWorkspace* ws, int start_id, int end_id) {
+     return bidirectional_search(graph, ws, start_id, end_id, true, "bidirectional_a_star_shortest_path");
+ }
+ 
+ PathResult find_shortest_path_ws(const Graph* graph, SearchWorkspace* ws, SearchAlgorithm algorithm, int start_id, int end_id) {
+     switch (algorithm) {
+         case ALGO_DIJKSTRA: return dijkstra_shortest_path_ws(graph, ws, start_id, end_id);
+         case ALGO_A_STAR: return a_star_shortest_path_ws(graph, ws, start_id, end_id);
+         case ALGO_BIDIRECTIONAL_DIJKSTRA: return bidirectional_dijkstra_shortest_path_ws(graph, ws, start_id, end_id);
+         case ALGO_BIDIRECTIONAL_A_STAR: return bidirectional_a_star_shortest_path_ws(graph, ws, start_id, end_id);
+     }
+     PathResult result = { .found = false };
+     fprintf(stderr, "[Algorithm Error] find_shortest_path: Unknown algorithm %d\n", (int)algorithm);
+     return result;
+ }
  
-     free(g_scores);
-     free(f_scores);
-     free(predecessors);
-     pq_destroy(pq);
+ // One-shot queries use a temporary workspace
+ PathResult find_shortest_path(const Graph* graph, SearchAlgorithm algorithm, int start_id, int end_id) {
+     PathResult result = { .found = false };
+     SearchWorkspace* ws = search_workspace_create(get_node_count(graph));
+     if (!ws) return result;
+     result = find_shortest_path_ws(graph, ws, algorithm, start_id, end_id);
+     search_workspace_destroy(ws);
      return result;
  }
  
+ PathResult dijkstra_shortest_path(const Graph* graph, int start_id, int end_id) {
+     return find_shortest_path(graph, ALGO_DIJKSTRA, start_id, end_id);
+ }
+ 
+ PathResult a_star_shortest_path(const Graph* graph, int start_id, int end_id) {
+     return find_shortest_path(graph, ALGO_A_STAR, start_id, end_id);
+ }
+ 
+ PathResult bidirectional_dijkstra_shortest_path(const Graph* graph, int start_id, int end_id) {
+     return find_shortest_path(graph, ALGO_BIDIRECTIONAL_DIJKSTRA, start_id, end_id);
+ }
+ 
+ PathResult bidirectional_a_star_shortest_path(const Graph* graph, int start_id, int end_id) {
+     return find_shortest_path(graph, ALGO_BIDIRECTIONAL_A_STAR, start_id, end_id);
+ }
+ 
+ const char* search_algorithm_name(SearchAlgorithm algorithm) {
+     switch (algorithm) {
+         case ALGO_DIJKSTRA: return "Dijkstra";
+         case ALGO_A_STAR: return "A*";
+         case ALGO_BIDIRECTIONAL_DIJKSTRA: return "Bidirectional Dijkstra";
+         case ALGO_BIDIRECTIONAL_A_STAR: return "Bidirectional A*";
+     }
+     return "Unknown";
+ }
+ 
  void free_path_result(PathResult* result) {
      if (result && result->path) {
-         free(result->path);
+         if (result->owns_path) free(result->path);
          result->path = NULL;
          result->path_length = 0;
          result->found = false;
+         result->owns_path = false;
      }
  }
  
@@ -215,8 +588,7 @@
      printf("Route:\n");
      for (int i = 0; i < result->path_length; i++) {
          int node_id = result->path[i];
-         const Node* node = get_node(graph, node_id);
-         printf("  %d. Node %d (%s)\n", i + 1, node_id, node->name);
+         printf("  %d. Node %d (%s)\n", i + 1, node_id, get_node_name(graph, node_id));
      }
      printf("\n");
  }
\ No newline at end of file
@@ -0,0 +1,302 @@
+/*
+ * All-Pairs Shortest Paths Implementation
+ *
+ * One full Dijkstra per target over the in-edges fills a column of each
+ * table. Targets are handed out to worker threads through an atomic counter,
+ * each worker owning its own SearchWorkspace. A node's next hop is its parent
+ * in that target's tree, so every route follows a single tree and hop chains
+ * cannot cycle, even through zero-weight edges.
+ */
+
+ #define _POSIX_C_SOURCE 200809L
+
+ #include "apsp.h"
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <float.h>
+ #include <pthread.h>
+ #include <stdatomic.h>
+ #include <unistd.h>
+
+ #define APSP_FILE_MAGIC "CNAVAPS"
+ #define APSP_FILE_VERSION 2          // 2: next hops from one tree per target
+ #define APSP_MAX_THREADS 64
+
+ typedef struct {
+     char magic[8];
+     uint32_t version;
+     int32_t num_nodes;
+     uint64_t map_hash;
+     uint64_t graph_fingerprint;
+ } ApspFileHeader;
+
+ typedef struct {
+     const Graph* graph;
+     DistanceMatrix* matrix;
+     atomic_int next_target;
+     atomic_bool failed;
+ } ApspJob;
+
+ // Writes column target_id from a reverse search, whose predecessors are the
+ // next hops toward the target. Cells of unreached nodes keep apsp_build's
+ // unreachable defaults.
+ static void fill_column(const DistanceMatrix* matrix, const SearchWorkspace* ws, int target_id,
+                         const int* order, int settled) {
+     int n = matrix->num_nodes;
+     float* distance = matrix->distance + target_id;
+     uint16_t* next_hop = matrix->next_hop + target_id;
+     const SearchSide* side = &ws->forward;
+     for (int i = 0; i < settled; i++) {
+         int u = order[i];
+         int parent = side->predecessor[u];
+         distance[(size_t)u * n] = (float)side->distance[u];
+         next_hop[(size_t)u * n] = (uint16_t)(parent == -1 ? u : parent);   // -1: the target itself
+     }
+ }
+
+ static void* apsp_worker(void* arg) {
+     ApspJob* job = arg;
+     int n = job->matrix->num_nodes;
+     SearchWorkspace* ws = search_workspace_create(n);
+     int* order = malloc(n * sizeof(int));
+     if (!ws || !order) {
+         atomic_store(&job->failed, true);
+     } else {
+         int target_id;
+         while (!atomic_load(&job->failed) && (target_id = atomic_fetch_add(&job->next_target, 1)) < n) {
+             int settled = dijkstra_settle_all_ws(job->graph, ws, target_id, true, order);
+             fill_column(job->matrix, ws, target_id, order, settled);
+         }
+     }
+     search_workspace_destroy(ws);
+     free(order);
+     return NULL;
+ }
+
+ static DistanceMatrix* apsp_allocate(int num_nodes) {
+     DistanceMatrix* matrix = calloc(1, sizeof(DistanceMatrix));
+     if (!matrix) return NULL;
+     size_t cells = (size_t)num_nodes * num_nodes + 1;
+     matrix->num_nodes = num_nodes;
+     matrix->distance = malloc(cells * sizeof(float));
+     matrix->next_hop = malloc(cells * sizeof(uint16_t));
+     if (!matrix->distance || !matrix->next_hop) {
+         apsp_destroy(matrix);
+         return NULL;
+     }
+     return matrix;
+ }
+
+ DistanceMatrix* apsp_build(const Graph* graph, int num_threads) {
+     if (!is_graph_frozen(graph)) {
+         fprintf(stderr, "[APSP Error] apsp_build: Graph is NULL or not frozen (call graph_freeze)\n");
+         return NULL;
+     }
+     int n = get_node_count(graph);
+     if (n > APSP_MAX_NODES) {
+         fprintf(stderr, "[APSP Error] apsp_build: %d nodes exceeds the all-pairs limit of %d\n", n, APSP_MAX_NODES);
+         return NULL;
+     }
+     DistanceMatrix* matrix = apsp_allocate(n);
+     if (!matrix) {
+         fprintf(stderr, "[APSP Error] apsp_build: Failed to allocate tables for %d nodes\n", n);
+         return NULL;
+     }
+     matrix->graph_fingerprint = graph_fingerprint(graph);
+     matrix->graph = graph;
+     matrix->graph_version = graph_version(graph);
+
+     if (num_threads <= 0) num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+     if (num_threads > APSP_MAX_THREADS) num_threads = APSP_MAX_THREADS;
+     if (num_threads > n) num_threads = n;
+     if (num_threads < 1) num_threads = 1;
+
+     // Columns are written with a stride, so set the unreachable defaults in one pass first
+     size_t cells = (size_t)n * n;
+     for (size_t i = 0; i < cells; i++) matrix->distance[i] = FLT_MAX;
+     memset(matrix->next_hop, 0xFF, cells * sizeof(uint16_t));   // APSP_NO_HOP
+
+     ApspJob job = { .graph = graph, .matrix = matrix };
+     atomic_init(&job.next_target, 0);
+     atomic_init(&job.failed, false);
+
+     // The calling thread is worker 0
+     pthread_t threads[APSP_MAX_THREADS];
+     int started = 0;
+     for (int t = 1; t < num_threads; t++) {
+         if (pthread_create(&threads[started], NULL, apsp_worker, &job) != 0) break;
+         started++;
+     }
+     apsp_worker(&job);
+     for (int t = 0; t < started; t++) pthread_join(threads[t], NULL);
+
+     if (atomic_load(&job.failed)) {
+         fprintf(stderr, "[APSP Error] apsp_build: A worker ran out of memory\n");
+         apsp_destroy(matrix);
+         return NULL;
+     }
+     return matrix;
+ }
+
+ void apsp_destroy(DistanceMatrix* matrix) {
+     if (!matrix) return;
+     free(matrix->distance);
+     free(matrix->next_hop);
+     free(matrix);
+ }
+
+ // FNV-1a over the raw file bytes; 0 if the file cannot be read
+ uint64_t apsp_map_hash(const char* map_filename) {
+     FILE* file = map_filename ? fopen(map_filename, "rb") : NULL;
+     if (!file) return 0;
+     uint64_t hash = 14695981039346656037ULL;
+     unsigned char buffer[65536];
+     size_t got;
+     while ((got = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+         for (size_t i = 0; i < got; i++) {
+             hash ^= buffer[i];
+             hash *= 1099511628211ULL;
+         }
+     }
+     fclose(file);
+     return hash;
+ }
+
+ bool apsp_save(const DistanceMatrix* matrix, const char* filename) {
+     if (!matrix || !filename) return false;
+     FILE* file = fopen(filename, "wb");
+     if (!file) {
+         fprintf(stderr, "[APSP Error] apsp_save: Could not open file '%s'.\n", filename);
+         return false;
+     }
+
+     ApspFileHeader header = { .version = APSP_FILE_VERSION };
+     memcpy(header.magic, APSP_FILE_MAGIC, sizeof(header.magic));
+     header.num_nodes = matrix->num_nodes;
+     header.map_hash = matrix->map_hash;
+     header.graph_fingerprint = matrix->graph_fingerprint;
+
+     size_t cells = (size_t)matrix->num_nodes * matrix->num_nodes;
+     bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+               && fwrite(matrix->distance, sizeof(float), cells, file) == cells
+               && fwrite(matrix->next_hop, sizeof(uint16_t), cells, file) == cells;
+     if (fclose(file) != 0) ok = false;
+     if (!ok) fprintf(stderr, "[APSP Error] apsp_save: Failed to write '%s'.\n", filename);
+     return ok;
+ }
+
+ DistanceMatrix* apsp_load(const Graph* graph, const char* filename, uint64_t map_hash) {
+     if (!is_graph_frozen(graph) || !filename) return NULL;
+     FILE* file = fopen(filename, "rb");
+     if (!file) return NULL;
+
+     ApspFileHeader header;
+     if (fread(&header, sizeof(header), 1, file) != 1
+         || memcmp(header.magic, APSP_FILE_MAGIC, sizeof(header.magic)) != 0) {
+         fprintf(stderr, "[APSP Error] apsp_load: '%s' is not an all-pairs table file.\n", filename);
+         fclose(file);
+         return NULL;
+     }
+     if (header.version != APSP_FILE_VERSION || header.map_hash != map_hash || header.num_nodes != get_node_count(graph)
+         || header.graph_fingerprint != graph_fingerprint(graph)) {
+         fclose(file);
+         return NULL;   // Stale cache; the caller rebuilds it
+     }
+
+     DistanceMatrix* matrix = apsp_allocate(header.num_nodes);
+     if (matrix) {
+         matrix->map_hash = header.map_hash;
+         matrix->graph_fingerprint = header.graph_fingerprint;
+         matrix->graph = graph;
+         matrix->graph_version = graph_version(graph);
+         size_t cells = (size_t)matrix->num_nodes * matrix->num_nodes;
+         bool ok = fread(matrix->distance, sizeof(float), cells, file) == cells
+                   && fread(matrix->next_hop, sizeof(uint16_t), cells, file) == cells;
+         if (!ok) {
+             fprintf(stderr, "[APSP Error] apsp_load: '%s' is truncated.\n", filename);
+             apsp_destroy(matrix);
+             matrix = NULL;
+         }
+     }
+     fclose(file);
+     return matrix;
+ }
+
+ DistanceMatrix* apsp_load_or_build(const Graph* graph, const char* map_filename, int num_threads) {
+     if (!map_filename) return NULL;
+     char cache_file[1024];
+     snprintf(cache_file, sizeof(cache_file), "%s.apsp", map_filename);
+
+     uint64_t map_hash = apsp_map_hash(map_filename);
+     DistanceMatrix* matrix = apsp_load(graph, cache_file, map_hash);
+     if (matrix) return matrix;
+
+     matrix = apsp_build(graph, num_threads);
+     if (matrix) {
+         matrix->map_hash = map_hash;
+         apsp_save(matrix, cache_file);   // A read-only directory only costs the cache
+     }
+     return matrix;
+ }
+
+ double apsp_distance(const DistanceMatrix* matrix, int start_id, int end_id) {
+     if (!matrix || start_id < 0 || end_id < 0 || start_id >= matrix->num_nodes || end_id >= matrix->num_nodes) {
+         return DBL_MAX;
+     }
+     if (graph_version(matrix->graph) != matrix->graph_version) {
+         fprintf(stderr, "[APSP Error] apsp_distance: Graph changed since build, rebuild tables\n");
+         return DBL_MAX;
+     }
+     float d = matrix->distance[(size_t)start_id * matrix->num_nodes + end_id];
+     return d == FLT_MAX ? DBL_MAX : d;
+ }
+
+ // Cheapest parallel edge, matching the one Dijkstra relaxed
+ static double edge_weight(const Graph* graph, int from_id, int to_id) {
+     const int* targets;
+     const double* weights;
+     int degree = get_out_edges(graph, from_id, &targets, &weights);
+     double best = DBL_MAX;
+     for (int e = 0; e < degree; e++) {
+         if (targets[e] == to_id && weights[e] < best) best = weights[e];
+     }
+     return best;
+ }
+
+ PathResult apsp_shortest_path(const DistanceMatrix* matrix, const Graph* graph, int start_id, int end_id) {
+     PathResult result = { .found = false };
+     if (!matrix || matrix->num_nodes != get_node_count(graph)) {
+         fprintf(stderr, "[APSP Error] apsp_shortest_path: Tables missing or built for a different graph\n");
+         return result;
+     }
+     if (graph_version(graph) != matrix->graph_version) {
+         fprintf(stderr, "[APSP Error] apsp_shortest_path: Graph changed since build, rebuild tables\n");
+         return result;
+     }
+     if (!is_valid_node(graph, start_id) || !is_valid_node(graph, end_id)) return result;
+
+     int n = matrix->num_nodes;
+     const uint16_t* column = matrix->next_hop + end_id;
+     if (column[(size_t)start_id * n] == APSP_NO_HOP) return result;
+
+     int len = 1;
+     for (int at = start_id; at != end_id; at = column[(size_t)at * n]) len++;
+
+     result.path = malloc(len * sizeof(int));
+     if (!result.path) return result;
+     result.owns_path = true;
+     result.path_length = len;
+     result.total_distance = 0.0;
+
+     int at = start_id;
+     result.path[0] = at;
+     for (int i = 1; i < len; i++) {
+         int next = column[(size_t)at * n];
+         result.total_distance += edge_weight(graph, at, next);
+         result.path[i] = next;
+         at = next;
+     }
+     result.found = true;
+     return result;
+ }
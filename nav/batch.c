@@ -0,0 +1,156 @@
+/*
+ * Batch Query Implementation
+ *
+ * Pairs are split into one contiguous range per worker. A range is a single
+ * 64-bit word (begin << 32 | end) updated with compare-and-swap: the owner
+ * takes items from the front, an idle worker steals the back half of another
+ * worker's range. begin only grows and end only shrinks while a range is
+ * shared, so a packed value never repeats and CAS cannot be fooled by ABA.
+ */
+
+ #define _POSIX_C_SOURCE 200809L
+
+ #include "batch.h"
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <stdint.h>
+ #include <pthread.h>
+ #include <stdatomic.h>
+ #include <unistd.h>
+
+ typedef struct {
+     _Alignas(64) _Atomic uint64_t range;   // One cache line per worker
+ } WorkRange;
+
+ typedef struct BatchJob BatchJob;
+
+ typedef struct {
+     BatchJob* job;
+     int index;
+ } BatchWorker;
+
+ struct BatchJob {
+     const Graph* graph;
+     const RoutePair* pairs;
+     SearchAlgorithm algorithm;
+     PathResult* results;
+     int num_workers;
+     WorkRange* ranges;
+ };
+
+ static inline uint64_t pack_range(uint32_t begin, uint32_t end) {
+     return ((uint64_t)begin << 32) | end;
+ }
+
+ static inline uint32_t range_begin(uint64_t range) { return (uint32_t)(range >> 32); }
+ static inline uint32_t range_end(uint64_t range) { return (uint32_t)range; }
+
+ // Owner side: takes the first item of its own range, -1 once it is empty
+ static int take_front(WorkRange* own) {
+     uint64_t range = atomic_load(&own->range);
+     while (range_begin(range) < range_end(range)) {
+         uint64_t taken = pack_range(range_begin(range) + 1, range_end(range));
+         if (atomic_compare_exchange_weak(&own->range, &range, taken)) return (int)range_begin(range);
+     }
+     return -1;
+ }
+
+ // Thief side: moves the back half of a victim's range into the thief's own
+ static bool steal_half(WorkRange* victim, WorkRange* own) {
+     uint64_t range = atomic_load(&victim->range);
+     while (range_begin(range) < range_end(range)) {
+         uint32_t begin = range_begin(range);
+         uint32_t end = range_end(range);
+         uint32_t middle = end - (end - begin + 1) / 2;
+         if (atomic_compare_exchange_weak(&victim->range, &range, pack_range(begin, middle))) {
+             atomic_store(&own->range, pack_range(middle, end));
+             return true;
+         }
+     }
+     return false;
+ }
+
+ static void* batch_worker(void* arg) {
+     BatchWorker* worker = arg;
+     BatchJob* job = worker->job;
+     WorkRange* own = &job->ranges[worker->index];
+     SearchWorkspace* ws = search_workspace_create(get_node_count(job->graph));
+
+     for (;;) {
+         int item;
+         while ((item = take_front(own)) != -1) {
+             const RoutePair* pair = &job->pairs[item];
+             // Without a workspace the query falls back to its allocating form
+             job->results[item] = ws
+                 ? find_shortest_path_ws(job->graph, ws, job->algorithm, pair->start_id, pair->end_id)
+                 : find_shortest_path(job->graph, job->algorithm, pair->start_id, pair->end_id);
+         }
+
+         // Own range is drained: sweep the others once, starting with the next worker
+         bool stolen = false;
+         for (int i = 1; i < job->num_workers && !stolen; i++) {
+             int victim = (worker->index + i) % job->num_workers;
+             stolen = steal_half(&job->ranges[victim], own);
+         }
+         if (!stolen) break;
+     }
+
+     search_workspace_destroy(ws);
+     return NULL;
+ }
+
+ bool batch_shortest_paths(const Graph* graph, const RoutePair* pairs, int num_pairs,
+                           SearchAlgorithm algorithm, PathResult* results, int num_threads) {
+     if (!graph || !pairs || !results || num_pairs < 0) {
+         fprintf(stderr, "[Batch Error] batch_shortest_paths: Graph, pairs or results is NULL\n");
+         return false;
+     }
+     if (!is_graph_frozen(graph)) {
+         fprintf(stderr, "[Batch Error] batch_shortest_paths: Graph is not frozen (call graph_freeze)\n");
+         return false;
+     }
+     for (int i = 0; i < num_pairs; i++) results[i] = (PathResult){ .found = false };
+     if (num_pairs == 0) return true;
+
+     if (num_threads <= 0) num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+     if (num_threads > BATCH_MAX_THREADS) num_threads = BATCH_MAX_THREADS;
+     if (num_threads > num_pairs) num_threads = num_pairs;
+     if (num_threads < 1) num_threads = 1;
+
+     WorkRange* ranges = aligned_alloc(_Alignof(WorkRange), num_threads * sizeof(WorkRange));
+     if (!ranges) {
+         fprintf(stderr, "[Batch Error] batch_shortest_paths: Failed to allocate %d work ranges\n", num_threads);
+         return false;
+     }
+     for (int w = 0; w < num_threads; w++) {
+         uint32_t begin = (uint32_t)((int64_t)num_pairs * w / num_threads);
+         uint32_t end = (uint32_t)((int64_t)num_pairs * (w + 1) / num_threads);
+         atomic_init(&ranges[w].range, pack_range(begin, end));
+     }
+
+     BatchJob job = {
+         .graph = graph, .pairs = pairs, .algorithm = algorithm, .results = results,
+         .num_workers = num_threads, .ranges = ranges
+     };
+     BatchWorker workers[BATCH_MAX_THREADS];
+     pthread_t threads[BATCH_MAX_THREADS];
+
+     // The calling thread is worker 0. A thread that fails to start leaves its
+     // range to be stolen by the others.
+     int started = 0;
+     for (int w = 1; w < num_threads; w++) {
+         workers[w] = (BatchWorker){ .job = &job, .index = w };
+         if (pthread_create(&threads[started], NULL, batch_worker, &workers[w]) == 0) started++;
+     }
+     workers[0] = (BatchWorker){ .job = &job, .index = 0 };
+     batch_worker(&workers[0]);
+     for (int t = 0; t < started; t++) pthread_join(threads[t], NULL);
+
+     free(ranges);
+     return true;
+ }
+
+ void batch_free_results(PathResult* results, int num_results) {
+     if (!results) return;
+     for (int i = 0; i < num_results; i++) free_path_result(&results[i]);
+ }
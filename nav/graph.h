@@ -2,46 +2,170 @@
  #define GRAPH_H
  
  #include <stdbool.h>
+ #include <stddef.h>
+ #include <stdint.h>
+ #include "arena.h"
+ #include "strtab.h"
+ 
+ #define GRAPH_DEFAULT_CAPACITY 256   // Initial node slots; the graph grows past this as needed
  
  typedef struct {
      int id;
+     int name_id;             // Index into Graph.names
      double latitude;
      double longitude;
-     char name[60];
  } Node;
  
  typedef struct Edge {
      int destination_id;
+     int road_name_id;        // Index into Graph.names
      double weight;
-     char road_name[30];
      struct Edge* next;
  } Edge;
  
+ // One logged weight change of the edges source_id -> destination_id
+ typedef struct {
+     int source_id;
+     int destination_id;
+     double old_weight;
+     double new_weight;       // INFINITY while the edge is closed
+     uint64_t version;        // Graph version the change produced
+ } GraphChange;
+ 
  typedef struct {
-     Node* nodes;
+     int source_id;
+     int destination_id;
+     double* weights;         // Weights graph_open_edge() restores, one per parallel
+                              // source_id -> destination_id edge in list order
+     int num_weights;
+ } ClosedEdge;
+ 
+ typedef struct {
+     Node* nodes;             // Cold per-node records; coordinates are copies of the arrays below
      Edge** adjacency_list;
      int num_nodes;
      int num_edges;
      int capacity;
+     uint64_t version;        // Bumped by every change to nodes or edges, so caches can spot stale results
+ 
+     // Hot coordinates, one entry per node, read by heuristics and scans
+     double* latitudes;
+     double* longitudes;
+     double* unit_vectors;    // x, y, z on the unit sphere per node, for the chord heuristic
+ 
+     // Frozen CSR adjacency, built by graph_freeze() and read by the searches.
+     // Out-edges of node u are edge_targets/edge_weights[edge_offsets[u] .. edge_offsets[u + 1]).
+     bool frozen;
+     int* edge_offsets;
+     int* edge_targets;
+     double* edge_weights;
+ 
+     // Reverse CSR (in-edges) for backward searches: sources of edges entering v
+     int* rev_edge_offsets;
+     int* rev_edge_sources;
+     double* rev_edge_weights;
+ 
+     // Read-only mapping of a binary map file. When set, the coordinate and
+     // CSR arrays point into it and the graph cannot be modified.
+     void* mapping;
+     size_t mapping_size;
+ 
+     Arena arena;             // Owns every Edge; released in one sweep by destroy_graph()
+     StringTable names;       // Interned node and road names, shared by equal strings
+ 
+     // Live updates. Weight changes since changes_base are logged so caches and
+     // search trees can repair only what a change touches; adding nodes or
+     // edges clears the log.
+     GraphChange* changes;
+     int num_changes;
+     int changes_capacity;
+     uint64_t changes_base;
+     ClosedEdge* closed_edges;
+     int num_closed_edges;
+     int closed_edges_capacity;
+     double* weight_copy;     // Private forward + reverse weights once a mapped graph is updated
  } Graph;
  
- // Lifecycle Management
+ #define GRAPH_DEFAULT_ROAD_NAME_ID 0   // "Path", interned first by create_graph()
+ #define GRAPH_CHANGE_LOG_CAPACITY 4096 // Logged weight changes before the log restarts
+ 
+ typedef enum {
+     GRAPH_UPDATE_SET_WEIGHT,
+     GRAPH_UPDATE_CLOSE,
+     GRAPH_UPDATE_OPEN
+ } GraphUpdateKind;
+ 
+ typedef struct {
+     GraphUpdateKind kind;
+     int source_id;
+     int destination_id;
+     double weight;           // Only read by GRAPH_UPDATE_SET_WEIGHT
+ } GraphUpdate;
+ 
+ // Lifecycle Management (capacity is a hint; 0 picks GRAPH_DEFAULT_CAPACITY)
  Graph* create_graph(int capacity);
  void destroy_graph(Graph* graph);
  
- // Modification
+ // Modification. Node storage grows geometrically, so a Node pointer from
+ // get_node() is only valid until the next add_node().
+ bool graph_reserve(Graph* graph, int capacity);
  int add_node(Graph* graph, double latitude, double longitude, const char* name);
  bool add_edge(Graph* graph, int source_id, int destination_id, double weight, const char* road_name);
  bool add_bidirectional_edge(Graph* graph, int node1_id, int node2_id, double weight, const char* road_name);
  
+ // Live updates to every source_id -> destination_id edge; add both directions
+ // of a two-way road separately. They work on frozen and mapped graphs
+ // without a reload. A closed edge weighs INFINITY until reopened, which gives
+ // each parallel edge its own weight back; setting the weight of a closed edge
+ // only changes the weight they all reopen with. graph_apply_updates()
+ // returns how many updates succeeded. Every update bumps graph_version(), so
+ // contraction hierarchies, landmarks and all-pairs tables built before it
+ // refuse queries until rebuilt; the route cache and shortest path trees
+ // repair themselves from graph_changes_since().
+ bool graph_set_edge_weight(Graph* graph, int source_id, int destination_id, double weight);
+ bool graph_close_edge(Graph* graph, int source_id, int destination_id);
+ bool graph_open_edge(Graph* graph, int source_id, int destination_id);
+ bool graph_is_edge_closed(const Graph* graph, int source_id, int destination_id);
+ int graph_apply_updates(Graph* graph, const GraphUpdate* updates, int num_updates);
+ 
+ // Weight changes made after the given version, oldest first. Returns -1 when
+ // the log no longer reaches back that far (nodes or edges were added, or the
+ // log restarted), in which case anything computed at that version must be
+ // rebuilt.
+ int graph_changes_since(const Graph* graph, uint64_t version, const GraphChange** changes);
+ 
+ // Packs the edge lists into contiguous CSR arrays. Any later add_node/add_edge
+ // discards the packed arrays until the graph is frozen again.
+ bool graph_freeze(Graph* graph);
+ bool is_graph_frozen(const Graph* graph);
+ uint64_t graph_fingerprint(const Graph* graph);
+ uint64_t graph_version(const Graph* graph);
+ 
  // Information & Queries
  const Node* get_node(const Graph* graph, int node_id);
+ const char* get_node_name(const Graph* graph, int node_id);
+ const double* get_latitudes(const Graph* graph);
+ const double* get_longitudes(const Graph* graph);
+ bool graph_bounds(const Graph* graph, double* min_lat, double* max_lat, double* min_lon, double* max_lon);
+ const char* graph_name(const Graph* graph, int name_id);
+ // Edge lists with road names, as built by add_edge(). Mapped graphs keep
+ // only the CSR arrays, so there this reports an error and returns NULL;
+ // use get_out_edges(), which works on every frozen graph.
  const Edge* get_edges(const Graph* graph, int node_id);
+ int get_out_edges(const Graph* graph, int node_id, const int** targets, const double** weights);
+ int get_in_edges(const Graph* graph, int node_id, const int** sources, const double** weights);
  bool is_valid_node(const Graph* graph, int node_id);
  int get_node_count(const Graph* graph);
  void print_graph(const Graph* graph);
  
- // File I/O
+ // File I/O. load_road_network() accepts both the text format and binary maps.
  bool load_road_network(Graph* graph, const char* filename);
+ // Maps the coordinate and CSR sections in place. Loading still takes O(n)
+ // to rebuild the node table and unit vectors and to intern the names, and
+ // checks only the header and the edge and name bounds, not the checksum.
+ bool load_binary_map(Graph* graph, const char* filename);
+ bool save_binary_map(const Graph* graph, const char* filename);
+ // Checks the header and the checksum of the whole payload (used by mapconv)
+ bool verify_binary_map(const char* filename);
  
  #endif // GRAPH_H
\ No newline at end of file
@@ -0,0 +1,115 @@
+/*
+ * Haversine Check - Compares haversine_batch() with haversine_distance().
+ *
+ * Usage: haversine_check [pairs per case]
+ *
+ * Built once per vector clone (make check), since the one a normal build
+ * runs depends on the CPU. Exits non-zero if any case is out of tolerance.
+ */
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <stdbool.h>
+ #include <math.h>
+ #include <float.h>
+
+ #include "utils.h"
+
+ #define CHECK_DEFAULT_PAIRS 1000000
+ #define CHECK_MAX_ULPS 4.0            // Allowed error where the result is well conditioned
+
+ typedef enum { CASE_RANDOM, CASE_ANTIPODAL, CASE_SUB_METRE, CASE_HUGE } CheckCase;
+
+ static const char* CASE_NAMES[] = { "random", "near-antipodal", "sub-metre", "beyond 1e6 degrees" };
+
+ static double uniform(double low, double high) {
+     return low + (high - low) * (rand() / (double)RAND_MAX);
+ }
+
+ static void make_pair(CheckCase which, double* lat1, double* lon1, double* lat2, double* lon2) {
+     *lat1 = uniform(-90.0, 90.0);
+     *lon1 = uniform(-180.0, 180.0);
+     switch (which) {
+         case CASE_RANDOM:
+             *lat2 = uniform(-90.0, 90.0);
+             *lon2 = uniform(-180.0, 180.0);
+             break;
+         case CASE_ANTIPODAL:
+             *lat2 = -*lat1 + uniform(-1e-3, 1e-3);
+             *lon2 = *lon1 + 180.0 + uniform(-1e-3, 1e-3);
+             break;
+         case CASE_SUB_METRE:
+             // Up to ~0.5 m apart, including identical points
+             *lat2 = *lat1 + (rand() % 8 ? uniform(-4e-6, 4e-6) : 0.0);
+             *lon2 = *lon1 + (rand() % 8 ? uniform(-4e-6, 4e-6) : 0.0);
+             break;
+         case CASE_HUGE:
+             // Mix out-of-range coordinates into otherwise ordinary lanes
+             *lat2 = uniform(-90.0, 90.0);
+             *lon2 = rand() % 2 ? uniform(-1e9, 1e9) : uniform(-180.0, 180.0);
+             if (rand() % 2) *lat1 = uniform(1e6, 1e12) * (rand() % 2 ? 1 : -1);
+             break;
+     }
+ }
+
+ // Error allowed against the scalar result: a few ulps of it, plus what a
+ // few ulps of error in the haversine term a become through 2 asin(sqrt(a)),
+ // which is large only near the antipode where 1 - a vanishes
+ static double tolerance(double reference) {
+     double a = sin(0.5 * reference / EARTH_RADIUS_KM);
+     a *= a;
+     double spread = EARTH_RADIUS_KM * CHECK_MAX_ULPS * DBL_EPSILON * sqrt(a / fmax(1.0 - a, DBL_EPSILON));
+     return CHECK_MAX_ULPS * DBL_EPSILON * reference + spread + DBL_MIN;
+ }
+
+ static bool run_case(CheckCase which, size_t count) {
+     double* lat1 = malloc(count * sizeof(double));
+     double* lon1 = malloc(count * sizeof(double));
+     double* lat2 = malloc(count * sizeof(double));
+     double* lon2 = malloc(count * sizeof(double));
+     double* batch = malloc(count * sizeof(double));
+     if (!lat1 || !lon1 || !lat2 || !lon2 || !batch) {
+         fprintf(stderr, "Failed to allocate %zu pairs.\n", count);
+         free(lat1); free(lon1); free(lat2); free(lon2); free(batch);
+         return false;
+     }
+     for (size_t i = 0; i < count; i++) make_pair(which, &lat1[i], &lon1[i], &lat2[i], &lon2[i]);
+     haversine_batch(lat1, lon1, lat2, lon2, batch, count);
+
+     size_t failures = 0;
+     double worst = 0.0;   // Largest error as a share of its tolerance
+     for (size_t i = 0; i < count; i++) {
+         double reference = haversine_distance(lat1[i], lon1[i], lat2[i], lon2[i]);
+         double error = fabs(batch[i] - reference);
+         double share = error / tolerance(reference);
+         if (share > worst) worst = share;
+         if (!(share <= 1.0) && failures++ < 5) {
+             fprintf(stderr, "  (%.9g, %.9g) -> (%.9g, %.9g): batch %.17g, scalar %.17g\n",
+                     lat1[i], lon1[i], lat2[i], lon2[i], batch[i], reference);
+         }
+     }
+     printf("%-20s %zu pairs, worst error %.3f of tolerance, %zu failures\n",
+            CASE_NAMES[which], count, worst, failures);
+     free(lat1); free(lon1); free(lat2); free(lon2); free(batch);
+     return failures == 0;
+ }
+
+ int main(int argc, char** argv) {
+ #ifdef HAVERSINE_PIN_AVX2
+     if (!__builtin_cpu_supports("avx2")) {
+         printf("AVX2 not supported on this CPU; skipping.\n");
+         return 0;
+     }
+ #endif
+     // An odd count also covers the scalar tail after the last full vector
+     size_t count = argc > 1 ? strtoul(argv[1], NULL, 10) : CHECK_DEFAULT_PAIRS;
+     count |= 1;
+     srand(1);
+
+     bool ok = true;
+     for (int which = CASE_RANDOM; which <= CASE_HUGE; which++) {
+         ok = run_case((CheckCase)which, count) && ok;
+     }
+     printf(ok ? "All cases within tolerance.\n" : "Some cases FAILED.\n");
+     return ok ? 0 : 1;
+ }
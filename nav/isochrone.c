@@ -0,0 +1,190 @@
+/*
+ * Isochrone Implementation
+ *
+ * Dijkstra from the source that never queues a label beyond the limit, so
+ * the work is proportional to the area found, not the map. Because every
+ * node within the limit is settled by the end, an out-edge of a reached node
+ * leads outside exactly when its far end was not settled; such edges are
+ * cut where the remaining distance runs out.
+ */
+
+ #include "isochrone.h"
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <math.h>
+
+ static bool grow(void** items, int count, int* capacity, size_t size) {
+     if (count < *capacity) return true;
+     int grown = *capacity > 0 ? *capacity * 2 : 64;
+     void* resized = realloc(*items, (size_t)grown * size);
+     if (!resized) return false;
+     *items = resized;
+     *capacity = grown;
+     return true;
+ }
+
+ static bool find_cuts(const Graph* graph, const SearchWorkspace* ws, Isochrone* area) {
+     const SearchSide* fwd = &ws->forward;
+     int capacity = 0;
+     for (int i = 0; i < area->num_reached; i++) {
+         int u = area->reached[i].node_id;
+         double remaining = area->max_distance - area->reached[i].distance;
+         for (int e = graph->edge_offsets[u]; e < graph->edge_offsets[u + 1]; e++) {
+             int v = graph->edge_targets[e];
+             double weight = graph->edge_weights[e];
+             if (side_is_settled(fwd, ws->generation, v) || !isfinite(weight)) continue;
+             if (!grow((void**)&area->cuts, area->num_cuts, &capacity, sizeof(EdgeCut))) return false;
+             double fraction = weight > 0.0 ? remaining / weight : 0.0;
+             area->cuts[area->num_cuts++] = (EdgeCut){
+                 .source_id = u,
+                 .destination_id = v,
+                 .fraction = fraction,
+                 .latitude = graph->latitudes[u] + fraction * (graph->latitudes[v] - graph->latitudes[u]),
+                 .longitude = graph->longitudes[u] + fraction * (graph->longitudes[v] - graph->longitudes[u])
+             };
+         }
+     }
+     return true;
+ }
+
+ // Outline
+
+ typedef struct {
+     double x;                // Longitude
+     double y;                // Latitude
+ } OutlinePoint;
+
+ static int compare_points(const void* a, const void* b) {
+     const OutlinePoint* p = a;
+     const OutlinePoint* q = b;
+     if (p->x != q->x) return p->x < q->x ? -1 : 1;
+     return (p->y > q->y) - (p->y < q->y);
+ }
+
+ static double cross(const OutlinePoint* o, const OutlinePoint* a, const OutlinePoint* b) {
+     return (a->x - o->x) * (b->y - o->y) - (a->y - o->y) * (b->x - o->x);
+ }
+
+ // Convex hull (Andrew's monotone chain) of the reached nodes and cut points
+ static bool build_outline(const Graph* graph, Isochrone* area) {
+     int n = area->num_reached + area->num_cuts;
+     OutlinePoint* points = malloc((size_t)n * sizeof(OutlinePoint));
+     OutlinePoint* hull = malloc((size_t)(n + 1) * sizeof(OutlinePoint));
+     if (!points || !hull) {
+         free(points);
+         free(hull);
+         return false;
+     }
+     for (int i = 0; i < area->num_reached; i++) {
+         int node_id = area->reached[i].node_id;
+         points[i] = (OutlinePoint){ graph->longitudes[node_id], graph->latitudes[node_id] };
+     }
+     for (int i = 0; i < area->num_cuts; i++) {
+         points[area->num_reached + i] = (OutlinePoint){ area->cuts[i].longitude, area->cuts[i].latitude };
+     }
+     qsort(points, n, sizeof(OutlinePoint), compare_points);
+
+     int size = 0;
+     for (int i = 0; i < n; i++) {
+         while (size >= 2 && cross(&hull[size - 2], &hull[size - 1], &points[i]) <= 0) size--;
+         hull[size++] = points[i];
+     }
+     for (int i = n - 2, lower = size + 1; i >= 0; i--) {
+         while (size >= lower && cross(&hull[size - 2], &hull[size - 1], &points[i]) <= 0) size--;
+         hull[size++] = points[i];
+     }
+     if (size > 1) size--;   // The last point repeats the first
+
+     area->outline = malloc((size_t)size * 2 * sizeof(double));
+     if (area->outline) {
+         for (int i = 0; i < size; i++) {
+             area->outline[2 * i] = hull[i].y;
+             area->outline[2 * i + 1] = hull[i].x;
+         }
+         area->num_outline = size;
+     }
+     free(points);
+     free(hull);
+     return area->outline != NULL;
+ }
+
+ // Search
+
+ Isochrone* isochrone_ws(const Graph* graph, SearchWorkspace* ws, int source_id, double max_distance,
+                         bool with_outline) {
+     if (!ws || !is_valid_node(graph, source_id) || !(max_distance >= 0.0)) {
+         fprintf(stderr, "[Isochrone Error] isochrone: Invalid workspace, source node %d or distance %g\n",
+                 source_id, max_distance);
+         return NULL;
+     }
+     if (!is_graph_frozen(graph)) {
+         fprintf(stderr, "[Isochrone Error] isochrone: Graph is not frozen (call graph_freeze)\n");
+         return NULL;
+     }
+     Isochrone* area = calloc(1, sizeof(Isochrone));
+     if (!area || !search_workspace_begin(ws, get_node_count(graph), false)) {
+         fprintf(stderr, "[Isochrone Error] isochrone: Failed to allocate search state\n");
+         free(area);
+         return NULL;
+     }
+     area->source_id = source_id;
+     area->max_distance = max_distance;
+
+     SearchSide* fwd = &ws->forward;
+     unsigned int gen = ws->generation;
+     double* distances = fwd->distance;
+     IndexedHeap* pq = &fwd->heap;
+     int capacity = 0;
+
+     side_touch(fwd, gen, source_id);
+     distances[source_id] = 0.0;
+     heap_push_or_decrease(pq, source_id, 0.0);
+     while (!heap_is_empty(pq)) {
+         int current_id = heap_pop_min(pq, NULL);
+         side_settle(ws, fwd, current_id);
+         if (!grow((void**)&area->reached, area->num_reached, &capacity, sizeof(ReachedNode))) {
+             fprintf(stderr, "[Isochrone Error] isochrone: Failed to grow the reached set\n");
+             isochrone_destroy(area);
+             return NULL;
+         }
+         area->reached[area->num_reached++] = (ReachedNode){ current_id, distances[current_id] };
+
+         for (int e = graph->edge_offsets[current_id]; e < graph->edge_offsets[current_id + 1]; e++) {
+             double new_dist = distances[current_id] + graph->edge_weights[e];
+             if (new_dist > max_distance) continue;   // Nodes past the limit are never touched
+             int neighbor_id = graph->edge_targets[e];
+             if (side_is_settled(fwd, gen, neighbor_id)) continue;
+             side_touch(fwd, gen, neighbor_id);
+             if (new_dist < distances[neighbor_id]) {
+                 distances[neighbor_id] = new_dist;
+                 fwd->predecessor[neighbor_id] = current_id;
+                 heap_push_or_decrease(pq, neighbor_id, new_dist);
+             }
+         }
+     }
+
+     if (with_outline && (!find_cuts(graph, ws, area) || !build_outline(graph, area))) {
+         fprintf(stderr, "[Isochrone Error] isochrone: Failed to allocate the outline\n");
+         isochrone_destroy(area);
+         return NULL;
+     }
+     return area;
+ }
+
+ // One-shot queries use a temporary workspace
+ Isochrone* isochrone(const Graph* graph, int source_id, double max_distance, bool with_outline) {
+     SearchWorkspace* ws = search_workspace_create(get_node_count(graph));
+     if (!ws) return NULL;
+     Isochrone* area = isochrone_ws(graph, ws, source_id, max_distance, with_outline);
+     search_workspace_destroy(ws);
+     return area;
+ }
+
+ void isochrone_destroy(Isochrone* area) {
+     if (!area) return;
+     free(area->reached);
+     free(area->cuts);
+     free(area->outline);
+     free(area);
+ }
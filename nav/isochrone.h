@@ -0,0 +1,45 @@
+/*
+ * Isochrones - Everything reachable within a distance of one node.
+ */
+
+ #ifndef ISOCHRONE_H
+ #define ISOCHRONE_H
+
+ #include "graph.h"
+ #include "algorithms.h"
+
+ typedef struct {
+     int node_id;
+     double distance;         // km from the source
+ } ReachedNode;
+
+ // Where the distance limit falls on an edge leaving the reachable area
+ typedef struct {
+     int source_id;           // Reached end
+     int destination_id;      // End beyond the limit
+     double fraction;         // Share of the edge within the limit, from source_id
+     double latitude;         // The cut point, interpolated along the edge
+     double longitude;
+ } EdgeCut;
+
+ typedef struct {
+     int source_id;
+     double max_distance;     // km
+     int num_reached;
+     ReachedNode* reached;    // Nearest first; the source comes first at distance 0
+     int num_cuts;
+     EdgeCut* cuts;           // NULL unless the outline was requested
+     int num_outline;
+     double* outline;         // Convex outline of the reached nodes and cut points as
+                              // latitude, longitude pairs, counter-clockwise; NULL unless requested
+ } Isochrone;
+
+ // Lifecycle Management. A bounded Dijkstra search that only touches nodes
+ // within max_distance km of source_id. with_outline adds the edge cuts and
+ // the outline, for drawing the area.
+ Isochrone* isochrone(const Graph* graph, int source_id, double max_distance, bool with_outline);
+ Isochrone* isochrone_ws(const Graph* graph, SearchWorkspace* workspace, int source_id, double max_distance,
+                         bool with_outline);
+ void isochrone_destroy(Isochrone* area);
+
+ #endif // ISOCHRONE_H
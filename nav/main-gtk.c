@@ -3,18 +3,45 @@
 #include <math.h>  
 #include "graph.h"
 #include "algorithms.h"
+#include "spatial.h"
+#include "nameindex.h"
+#include "routecache.h"
+#include "spt.h"
+#include "kpaths.h"
+#include "isochrone.h"
+
+#define NODE_SEARCH_MAX_RESULTS 200 // Names listed per search-box keystroke
+#define ROUTE_CACHE_CAPACITY 256 // Recent routes kept for repeated queries
+#define ALTERNATIVE_ROUTES 3 // Ranked routes drawn, counting the shortest
+#define REACH_DEFAULT_METRES 300 // Initial limit of the reachable area
 
 // Struct to hold widget pointers and shared data
 typedef struct {
     GtkEntry* start_entry;
     GtkEntry* end_entry;
     GtkWidget* dijkstra_radio;
+    GtkWidget* a_star_radio;
+    GtkWidget* bidirectional_dijkstra_radio;
+    GtkWidget* bidirectional_a_star_radio;
     GtkDrawingArea* drawing_area;
     GtkLabel* status_label; // For short status messages
     GtkLabel* node_list_label; // For the long list of nodes
+    GtkSearchEntry* node_search; // Filters the node list by name prefix
+    GtkWidget* heat_map_check; // Colours nodes by distance from the start node
+    GtkWidget* alternatives_check; // Also draws the next-shortest routes
+    GtkWidget* reach_check; // Shades the area within walking distance of the start node
+    GtkWidget* reach_spin; // That distance, in metres
 
     Graph* graph;
-    PathResult path_result; // Stores the last found path
+    SpatialIndex* spatial; // Snaps map clicks to the nearest node
+    NameIndex* names; // Node lookup by name for the entries and the search box
+    SearchWorkspace* workspace; // Reused by every search on the loaded graph
+    RouteCache* route_cache; // Repeated queries skip the search
+    const SharedRoute* route; // The last found path, shared with the cache
+    ShortestPathTree* tree; // Distances from the start node for the heat map
+    PathResult alternatives[ALTERNATIVE_ROUTES]; // Ranked routes; [0] repeats the shortest
+    int num_alternatives;
+    Isochrone* reach; // Nodes within the reach distance of the start node, with its outline
 
     // Bounding box of the loaded graph for coordinate mapping
     double min_lon, max_lon, min_lat, max_lat;
@@ -22,6 +49,8 @@ typedef struct {
     // The true, corrected aspect ratio of the map
     double map_aspect_ratio; 
 
+    bool pick_end_next; // Map clicks alternate between start and end node
+
 } AppWidgets;
 
 /*
@@ -35,17 +64,7 @@ static void find_graph_bounds(AppWidgets* app) {
         return;
     }
 
-    const Node* first_node = get_node(app->graph, 0);
-    app->min_lon = app->max_lon = first_node->longitude;
-    app->min_lat = app->max_lat = first_node->latitude;
-
-    for (int i = 1; i < get_node_count(app->graph); i++) {
-        const Node* n = get_node(app->graph, i);
-        if (n->longitude < app->min_lon) app->min_lon = n->longitude;
-        if (n->longitude > app->max_lon) app->max_lon = n->longitude;
-        if (n->latitude < app->min_lat) app->min_lat = n->latitude;
-        if (n->latitude > app->max_lat) app->max_lat = n->latitude;
-    }
+    graph_bounds(app->graph, &app->min_lat, &app->max_lat, &app->min_lon, &app->max_lon);
 
     double padding_lon = (app->max_lon - app->min_lon) * 0.05;
     double padding_lat = (app->max_lat - app->min_lat) * 0.05;
@@ -83,6 +102,29 @@ static void get_normalized_coords(AppWidgets* app, double lon, double lat, doubl
     *ny = (map_height == 0.0) ? 0.5 : (1.0 - (lat - app->min_lat) / map_height);
 }
 
+/*
+ Computes the aspect-ratio-preserving scale and offset of the map inside a widget of the given size.
+*/
+static void get_map_transform(AppWidgets* app, int width, int height,
+                              double* scale_x, double* scale_y, double* offset_x, double* offset_y)
+{
+    double window_aspect_ratio = (double)width / (double)height;
+
+    if (window_aspect_ratio > app->map_aspect_ratio) {
+        // Window is wider than the map (letterbox)
+        *scale_y = height;
+        *scale_x = height * app->map_aspect_ratio;
+        *offset_x = (width - *scale_x) / 2.0;
+        *offset_y = 0;
+    } else {
+        // Window is taller than the map (pillarbox)
+        *scale_x = width;
+        *scale_y = width / app->map_aspect_ratio;
+        *offset_x = 0;
+        *offset_y = (height - *scale_y) / 2.0;
+    }
+}
+
 
 // --- Drawing Function ---
 
@@ -100,38 +142,46 @@ static void on_draw(GtkDrawingArea* area, cairo_t* cr, int width, int height, gp
     if (!app->graph) return; // No graph loaded
 
     // Aspect-Ratio-Preserving Scaling 
-    double window_aspect_ratio = (double)width / (double)height;
     double scale_x, scale_y, offset_x, offset_y;
+    get_map_transform(app, width, height, &scale_x, &scale_y, &offset_x, &offset_y);
 
-    if (window_aspect_ratio > app->map_aspect_ratio) {
-        // Window is wider than the map (letterbox)
-        scale_y = height;
-        scale_x = height * app->map_aspect_ratio;
-        offset_x = (width - scale_x) / 2.0;
-        offset_y = 0;
-    } else {
-        // Window is taller than the map (pillarbox)
-        scale_x = width;
-        scale_y = width / app->map_aspect_ratio;
-        offset_x = 0;
-        offset_y = (height - scale_y) / 2.0;
-    }
 
+    // Variables for edge drawing are correctly defined here:
+    double x1, y1, x2, y2, nx1, ny1, nx2, ny2; 
+    const double* lat = get_latitudes(app->graph);
+    const double* lon = get_longitudes(app->graph);
+
+    // 1. Shade the reachable area beneath the roads, with ticks where the limit cuts them
+    if (app->reach && app->reach->num_outline > 0) {
+        const Isochrone* reach = app->reach;
+        for (int i = 0; i < reach->num_outline; i++) {
+            get_normalized_coords(app, reach->outline[2 * i + 1], reach->outline[2 * i], &nx1, &ny1);
+            cairo_line_to(cr, (nx1 * scale_x) + offset_x, (ny1 * scale_y) + offset_y);
+        }
+        cairo_close_path(cr);
+        cairo_set_source_rgba(cr, 0.2, 0.9, 0.4, 0.15);
+        cairo_fill_preserve(cr);
+        cairo_set_source_rgba(cr, 0.2, 0.9, 0.4, 0.6);
+        cairo_set_line_width(cr, 1.5);
+        cairo_stroke(cr);
+        for (int i = 0; i < reach->num_cuts; i++) {
+            get_normalized_coords(app, reach->cuts[i].longitude, reach->cuts[i].latitude, &nx1, &ny1);
+            cairo_arc(cr, (nx1 * scale_x) + offset_x, (ny1 * scale_y) + offset_y, 3.0, 0, 2 * M_PI);
+            cairo_fill(cr);
+        }
+    }
 
     // 2. Draw all edges (roads)
     cairo_set_source_rgb(cr, 0.5, 0.5, 0.5); // Grey for roads
     cairo_set_line_width(cr, 1.0);
-    // Variables for edge drawing are correctly defined here:
-    double x1, y1, x2, y2, nx1, ny1, nx2, ny2; 
     for (int i = 0; i < get_node_count(app->graph); i++) {
-        const Node* n1 = get_node(app->graph, i);
-        const Edge* edge = get_edges(app->graph, n1->id);
-        while (edge) {
-            if (n1->id < edge->destination_id) { // Only draw edges once
-                const Node* n2 = get_node(app->graph, edge->destination_id);
-                
-                get_normalized_coords(app, n1->longitude, n1->latitude, &nx1, &ny1);
-                get_normalized_coords(app, n2->longitude, n2->latitude, &nx2, &ny2);
+        const int* targets;
+        int degree = get_out_edges(app->graph, i, &targets, NULL);
+        for (int e = 0; e < degree; e++) {
+            int j = targets[e];
+            if (i < j) { // Only draw edges once
+                get_normalized_coords(app, lon[i], lat[i], &nx1, &ny1);
+                get_normalized_coords(app, lon[j], lat[j], &nx2, &ny2);
 
                 // Apply the new scaling
                 x1 = (nx1 * scale_x) + offset_x;
@@ -143,24 +193,33 @@ static void on_draw(GtkDrawingArea* area, cairo_t* cr, int width, int height, gp
                 cairo_line_to(cr, x2, y2);
                 cairo_stroke(cr);
             }
-            edge = edge->next;
         }
     }
 
     // 3. Draw all nodes (intersections) and their names
     // Declare the variables needed for this section:
     double x, y, nx, ny; 
+    double max_distance = shortest_path_tree_max_distance(app->tree);
     for (int i = 0; i < get_node_count(app->graph); i++) {
-        const Node* n = get_node(app->graph, i);
-        
-        get_normalized_coords(app, n->longitude, n->latitude, &nx, &ny);
+        get_normalized_coords(app, lon[i], lat[i], &nx, &ny);
         
         // Apply the new scaling
         x = (nx * scale_x) + offset_x;
         y = (ny * scale_y) + offset_y;
         
         // Draw the node circle
-        cairo_set_source_rgb(cr, 0.2, 0.8, 1.0); // Light blue for nodes
+        if (app->tree) {
+            // Heat map: blue near the start node, red at the farthest, grey if unreachable
+            double distance = shortest_path_tree_distance(app->tree, i);
+            if (distance == DBL_MAX) {
+                cairo_set_source_rgb(cr, 0.35, 0.35, 0.35);
+            } else {
+                double t = max_distance > 0.0 ? distance / max_distance : 0.0;
+                cairo_set_source_rgb(cr, t, 0.2, 1.0 - t);
+            }
+        } else {
+            cairo_set_source_rgb(cr, 0.2, 0.8, 1.0); // Light blue for nodes
+        }
         // FONT CHANGE 1: Increase node radius from 3.0 to 5.0
         cairo_arc(cr, x, y, 5.0, 0, 2 * M_PI); // 5px radius circle
         cairo_fill_preserve(cr);
@@ -170,7 +229,7 @@ static void on_draw(GtkDrawingArea* area, cairo_t* cr, int width, int height, gp
 
         // Draw node name and ID
         char label_text[80];
-        snprintf(label_text, sizeof(label_text), "[%d] %s", n->id, n->name);
+        snprintf(label_text, sizeof(label_text), "[%d] %s", i, get_node_name(app->graph, i));
         
         cairo_set_source_rgb(cr, 0.9, 0.9, 0.9);
         cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
@@ -182,17 +241,47 @@ static void on_draw(GtkDrawingArea* area, cairo_t* cr, int width, int height, gp
         cairo_show_text(cr, label_text);
     }
 
-    // 4. Draw the found path (if it exists)
-    if (app->path_result.found) {
+    // Ring the nodes inside the reachable area
+    if (app->reach) {
+        cairo_set_source_rgb(cr, 0.2, 0.9, 0.4);
+        cairo_set_line_width(cr, 1.5);
+        for (int i = 0; i < app->reach->num_reached; i++) {
+            int node_id = app->reach->reached[i].node_id;
+            get_normalized_coords(app, lon[node_id], lat[node_id], &nx, &ny);
+            cairo_new_sub_path(cr);
+            cairo_arc(cr, (nx * scale_x) + offset_x, (ny * scale_y) + offset_y, 7.5, 0, 2 * M_PI);
+        }
+        cairo_stroke(cr);
+    }
+
+    // 4. Draw the alternative routes beneath the shortest one
+    cairo_set_source_rgb(cr, 1.0, 0.6, 0.0); // Orange for alternatives
+    cairo_set_line_width(cr, 2.0);
+    for (int r = 1; r < app->num_alternatives; r++) {
+        const PathResult* alternative = &app->alternatives[r];
+        for (int i = 0; i < alternative->path_length - 1; i++) {
+            int a = alternative->path[i];
+            int b = alternative->path[i + 1];
+            get_normalized_coords(app, lon[a], lat[a], &nx1, &ny1);
+            get_normalized_coords(app, lon[b], lat[b], &nx2, &ny2);
+            cairo_move_to(cr, (nx1 * scale_x) + offset_x, (ny1 * scale_y) + offset_y);
+            cairo_line_to(cr, (nx2 * scale_x) + offset_x, (ny2 * scale_y) + offset_y);
+            cairo_stroke(cr);
+        }
+    }
+
+    // 5. Draw the found path (if it exists)
+    if (app->route && app->route->result.found) {
+        const PathResult* path_result = &app->route->result;
         cairo_set_source_rgb(cr, 1.0, 0.0, 0.2); // Bright red for path
         cairo_set_line_width(cr, 3.0);
         // x1, y1, x2, y2, nx1, ny1, nx2, ny2 are still in scope from section 2
-        for (int i = 0; i < app->path_result.path_length - 1; i++) {
-            const Node* n1 = get_node(app->graph, app->path_result.path[i]);
-            const Node* n2 = get_node(app->graph, app->path_result.path[i + 1]);
+        for (int i = 0; i < path_result->path_length - 1; i++) {
+            int a = path_result->path[i];
+            int b = path_result->path[i + 1];
 
-            get_normalized_coords(app, n1->longitude, n1->latitude, &nx1, &ny1);
-            get_normalized_coords(app, n2->longitude, n2->latitude, &nx2, &ny2);
+            get_normalized_coords(app, lon[a], lat[a], &nx1, &ny1);
+            get_normalized_coords(app, lon[b], lat[b], &nx2, &ny2);
             
             // Apply the new scaling
             x1 = (nx1 * scale_x) + offset_x;
@@ -210,6 +299,71 @@ static void on_draw(GtkDrawingArea* area, cairo_t* cr, int width, int height, gp
 
 // --- GTK Callbacks ---
 
+/*
+ Reads a node from an entry: a numeric ID, or else a node name (case-insensitive).
+*/
+static int parse_node_entry(AppWidgets* app, const char* text) {
+    char* end;
+    int node_id = (int)strtol(text, &end, 10);
+    if (end != text) return node_id;
+    return app->names ? name_index_find(app->names, text) : -1;
+}
+
+/*
+ Frees the alternative routes from the last search.
+*/
+static void clear_alternatives(AppWidgets* app) {
+    for (int r = 0; r < app->num_alternatives; r++) {
+        free_path_result(&app->alternatives[r]);
+    }
+    app->num_alternatives = 0;
+}
+
+/*
+ Keeps the heat map's tree rooted at the start node and current with the graph,
+ or drops it when the heat map is off. One search covers every node.
+*/
+static void update_heat_map(AppWidgets* app) {
+    bool active = gtk_check_button_get_active(GTK_CHECK_BUTTON(app->heat_map_check));
+    int start_node = app->graph ? parse_node_entry(app, gtk_editable_get_text(GTK_EDITABLE(app->start_entry))) : -1;
+    if (!active || !is_valid_node(app->graph, start_node)) {
+        shortest_path_tree_destroy(app->tree);
+        app->tree = NULL;
+        return;
+    }
+    if (app->tree && app->tree->source_id == start_node && shortest_path_tree_update(app->tree, app->graph, app->workspace)) {
+        return;
+    }
+    shortest_path_tree_destroy(app->tree);
+    app->tree = shortest_path_tree_ws(app->graph, app->workspace, start_node);
+}
+
+static void on_heat_map_toggled(GtkCheckButton* button, gpointer data) {
+    AppWidgets* app = (AppWidgets*)data;
+    update_heat_map(app);
+    gtk_widget_queue_draw(GTK_WIDGET(app->drawing_area));
+}
+
+/*
+ Recomputes the area within the chosen distance of the start node, or drops it
+ when the option is off. The search stops at the limit, so it stays cheap on any map.
+*/
+static void update_reach_area(AppWidgets* app) {
+    isochrone_destroy(app->reach);
+    app->reach = NULL;
+    bool active = gtk_check_button_get_active(GTK_CHECK_BUTTON(app->reach_check));
+    int start_node = app->graph ? parse_node_entry(app, gtk_editable_get_text(GTK_EDITABLE(app->start_entry))) : -1;
+    if (!active || !is_valid_node(app->graph, start_node)) return;
+    double max_km = gtk_spin_button_get_value(GTK_SPIN_BUTTON(app->reach_spin)) / 1000.0;
+    app->reach = isochrone_ws(app->graph, app->workspace, start_node, max_km, true);
+}
+
+static void on_reach_area_changed(GtkWidget* widget, gpointer data) {
+    AppWidgets* app = (AppWidgets*)data;
+    update_reach_area(app);
+    gtk_widget_queue_draw(GTK_WIDGET(app->drawing_area));
+}
+
 /*
  Callback for the "Find Path" button.
 */
@@ -217,45 +371,126 @@ static void on_find_path_clicked(GtkWidget* widget, gpointer data) {
     AppWidgets* app = (AppWidgets*)data;
 
     // Clear the old path before finding a new one
-    free_path_result(&app->path_result);
+    route_cache_release(app->route);
+    app->route = NULL;
+    clear_alternatives(app);
 
     const char* start_text = gtk_editable_get_text(GTK_EDITABLE(app->start_entry));
     const char* end_text = gtk_editable_get_text(GTK_EDITABLE(app->end_entry));
-    int start_node = atoi(start_text);
-    int end_node = atoi(end_text);
 
     if (!app->graph) {
         gtk_label_set_text(app->status_label, "Error: No map loaded.");
         return;
     }
+    int start_node = parse_node_entry(app, start_text);
+    int end_node = parse_node_entry(app, end_text);
     if (!is_valid_node(app->graph, start_node) || !is_valid_node(app->graph, end_node)) {
         char buffer[100];
-        snprintf(buffer, sizeof(buffer), "Error: Invalid node ID. Use 0-%d.", get_node_count(app->graph) - 1);
+        snprintf(buffer, sizeof(buffer), "Error: Unknown node. Use an ID 0-%d or a node name.", get_node_count(app->graph) - 1);
         gtk_label_set_text(app->status_label, buffer);
         return;
     }
 
-    gboolean use_dijkstra = gtk_check_button_get_active(GTK_CHECK_BUTTON(app->dijkstra_radio));
-    const char* algo_name = use_dijkstra ? "Dijkstra" : "A*";
-
-    if (use_dijkstra) {
-        app->path_result = dijkstra_shortest_path(app->graph, start_node, end_node);
-    } else {
-        app->path_result = a_star_shortest_path(app->graph, start_node, end_node);
+    SearchAlgorithm algorithm = ALGO_A_STAR;
+    if (gtk_check_button_get_active(GTK_CHECK_BUTTON(app->dijkstra_radio))) {
+        algorithm = ALGO_DIJKSTRA;
+    } else if (gtk_check_button_get_active(GTK_CHECK_BUTTON(app->bidirectional_dijkstra_radio))) {
+        algorithm = ALGO_BIDIRECTIONAL_DIJKSTRA;
+    } else if (gtk_check_button_get_active(GTK_CHECK_BUTTON(app->bidirectional_a_star_radio))) {
+        algorithm = ALGO_BIDIRECTIONAL_A_STAR;
     }
+    const char* algo_name = search_algorithm_name(algorithm);
+
+    uint64_t hits_before = route_cache_stats(app->route_cache).hits;
+    app->route = route_cache_get(app->route_cache, app->workspace, algorithm, start_node, end_node);
+    bool cached = route_cache_stats(app->route_cache).hits > hits_before;
     
-    if (app->path_result.found) {
-        char buffer[100];
-        snprintf(buffer, sizeof(buffer), "Path found (%s): %.2f km", algo_name, app->path_result.total_distance);
+    if (app->route && app->route->result.found) {
+        if (gtk_check_button_get_active(GTK_CHECK_BUTTON(app->alternatives_check))) {
+            int found = k_shortest_paths_ws(app->graph, app->workspace, start_node, end_node,
+                                            ALTERNATIVE_ROUTES, app->alternatives);
+            app->num_alternatives = found > 0 ? found : 0;
+        }
+        char alternatives_text[40] = "";
+        if (app->num_alternatives > 1) {
+            snprintf(alternatives_text, sizeof(alternatives_text), ", next %.2f km",
+                     app->alternatives[1].total_distance);
+        }
+        char buffer[140];
+        snprintf(buffer, sizeof(buffer), "Path found (%s%s): %.2f km%s", algo_name, cached ? ", cached" : "",
+                 app->route->result.total_distance, alternatives_text);
         gtk_label_set_text(app->status_label, buffer);
     } else {
         gtk_label_set_text(app->status_label, "No path found between these locations.");
     }
+    update_heat_map(app);
+    update_reach_area(app);
     
     // IMPORTANT: Force the drawing area to redraw itself
     gtk_widget_queue_draw(GTK_WIDGET(app->drawing_area));
 }
 
+/*
+ Snaps a click on the map to the nearest node and fills the start or end entry with it.
+*/
+static void on_map_pressed(GtkGestureClick* gesture, int n_press, double x, double y, gpointer data) {
+    AppWidgets* app = (AppWidgets*)data;
+    if (!app->graph || !app->spatial) return;
+
+    // Undo the drawing transform: widget pixels -> normalized -> lon/lat
+    GtkWidget* area = GTK_WIDGET(app->drawing_area);
+    double scale_x, scale_y, offset_x, offset_y;
+    get_map_transform(app, gtk_widget_get_width(area), gtk_widget_get_height(area),
+                      &scale_x, &scale_y, &offset_x, &offset_y);
+    double nx = (x - offset_x) / scale_x;
+    double ny = (y - offset_y) / scale_y;
+    double lon = app->min_lon + nx * (app->max_lon - app->min_lon);
+    double lat = app->min_lat + (1.0 - ny) * (app->max_lat - app->min_lat);
+
+    double distance_km;
+    int node_id = spatial_nearest(app->spatial, lat, lon, &distance_km);
+    if (node_id == -1) return;
+
+    char id_text[16];
+    snprintf(id_text, sizeof(id_text), "%d", node_id);
+    GtkEntry* entry = app->pick_end_next ? app->end_entry : app->start_entry;
+    gtk_editable_set_text(GTK_EDITABLE(entry), id_text);
+
+    char buffer[160];
+    snprintf(buffer, sizeof(buffer), "%s set to [%d] %s (%.0f m from click).",
+             app->pick_end_next ? "End" : "Start", node_id, get_node_name(app->graph, node_id), distance_km * 1000.0);
+    gtk_label_set_text(app->status_label, buffer);
+    app->pick_end_next = !app->pick_end_next;
+}
+
+/*
+ Fills the node list: every node, or only those whose names start with the search text.
+*/
+static void update_node_list(AppWidgets* app) {
+    if (!app->graph) return;
+    const char* prefix = gtk_editable_get_text(GTK_EDITABLE(app->node_search));
+    GString* list_str = g_string_new("");
+
+    if (prefix[0] == '\0' || !app->names) {
+        for (int i = 0; i < get_node_count(app->graph); i++) {
+            g_string_append_printf(list_str, "[%d] %s\n", i, get_node_name(app->graph, i));
+        }
+    } else {
+        int matches[NODE_SEARCH_MAX_RESULTS];
+        int count = name_index_complete(app->names, prefix, NODE_SEARCH_MAX_RESULTS, matches);
+        for (int i = 0; i < count; i++) {
+            g_string_append_printf(list_str, "[%d] %s\n", matches[i], get_node_name(app->graph, matches[i]));
+        }
+        if (count <= 0) g_string_append(list_str, "No matching nodes.");
+    }
+    gtk_label_set_text(app->node_list_label, list_str->str);
+    g_string_free(list_str, TRUE);
+}
+
+static void on_node_search_changed(GtkSearchEntry* entry, gpointer data) {
+    update_node_list((AppWidgets*)data);
+}
+
 /*
  Loads the single, hard-coded default map.
 */
@@ -268,10 +503,24 @@ static void load_default_map(gpointer data) {
         destroy_graph(app->graph);
         app->graph = NULL;
     }
-    free_path_result(&app->path_result);
+    spatial_index_destroy(app->spatial);
+    app->spatial = NULL;
+    name_index_destroy(app->names);
+    app->names = NULL;
+    route_cache_release(app->route);
+    app->route = NULL;
+    route_cache_destroy(app->route_cache);
+    app->route_cache = NULL;
+    shortest_path_tree_destroy(app->tree);
+    app->tree = NULL;
+    isochrone_destroy(app->reach);
+    app->reach = NULL;
+    clear_alternatives(app);
+    search_workspace_destroy(app->workspace);
+    app->workspace = NULL;
     gtk_label_set_text(app->node_list_label, ""); // Clear old node list
     
-    app->graph = create_graph(250); // Set a reasonable default capacity
+    app->graph = create_graph(GRAPH_DEFAULT_CAPACITY); // Grows to fit the map
     if (!app->graph) {
         gtk_label_set_text(app->status_label, "Error: Could not allocate memory for graph.");
         return;
@@ -285,15 +534,14 @@ static void load_default_map(gpointer data) {
         
         // Find the new map's boundaries and aspect ratio
         find_graph_bounds(app);
+        app->workspace = search_workspace_create(get_node_count(app->graph));
+        app->route_cache = route_cache_create(app->graph, ROUTE_CACHE_CAPACITY);
+        app->spatial = spatial_index_build(app->graph);
+
+        app->names = name_index_build(app->graph);
 
         // --- Populate the node list ---
-        GString* list_str = g_string_new("");
-        for (int i = 0; i < get_node_count(app->graph); i++) {
-            const Node* node = get_node(app->graph, i);
-            g_string_append_printf(list_str, "[%d] %s\n", node->id, node->name);
-        }
-        gtk_label_set_text(app->node_list_label, list_str->str);
-        g_string_free(list_str, TRUE);
+        update_node_list(app);
 
     } else {
         gtk_label_set_text(app->status_label, "Error: Failed to load 'dehradun_campus.txt'.");
@@ -313,7 +561,14 @@ static void on_window_destroy(GtkWidget* widget, gpointer data) {
     if (app->graph) {
         destroy_graph(app->graph);
     }
-    free_path_result(&app->path_result);
+    spatial_index_destroy(app->spatial);
+    name_index_destroy(app->names);
+    route_cache_release(app->route);
+    route_cache_destroy(app->route_cache);
+    shortest_path_tree_destroy(app->tree);
+    isochrone_destroy(app->reach);
+    clear_alternatives(app);
+    search_workspace_destroy(app->workspace);
     g_slice_free(AppWidgets, app);
 }
 
@@ -342,7 +597,14 @@ static void on_app_activate(GtkApplication* app, gpointer user_data) {
     // Allocate the struct to hold our widget pointers
     AppWidgets* widgets = g_slice_new0(AppWidgets);
     widgets->graph = NULL;
-    widgets->path_result.found = false;
+    widgets->spatial = NULL;
+    widgets->names = NULL;
+    widgets->workspace = NULL;
+    widgets->route_cache = NULL;
+    widgets->route = NULL;
+    widgets->tree = NULL;
+    widgets->num_alternatives = 0;
+    widgets->reach = NULL;
     widgets->map_aspect_ratio = 1.0; // Default
 
     // Title Label
@@ -364,7 +626,7 @@ static void on_app_activate(GtkApplication* app, gpointer user_data) {
     gtk_box_append(GTK_BOX(controls_box), grid);
 
     widgets->start_entry = GTK_ENTRY(gtk_entry_new());
-    gtk_entry_set_placeholder_text(widgets->start_entry, "e.g. 0");
+    gtk_entry_set_placeholder_text(widgets->start_entry, "e.g. 0 or a node name");
     gtk_grid_attach(GTK_GRID(grid), gtk_label_new("Start Node:"), 0, 0, 1, 1);
     gtk_grid_attach(GTK_GRID(grid), GTK_WIDGET(widgets->start_entry), 1, 0, 1, 1);
 
@@ -380,11 +642,38 @@ static void on_app_activate(GtkApplication* app, gpointer user_data) {
     
     gtk_box_append(GTK_BOX(algo_box), gtk_label_new("Algorithm:"));
     widgets->dijkstra_radio = gtk_check_button_new_with_label("Dijkstra (Slow, Complete)");
-    GtkWidget* a_star_radio = gtk_check_button_new_with_label("A* (Fast, Optimized)");
-    gtk_check_button_set_group(GTK_CHECK_BUTTON(a_star_radio), GTK_CHECK_BUTTON(widgets->dijkstra_radio));
-    gtk_check_button_set_active(GTK_CHECK_BUTTON(a_star_radio), TRUE); // Default to A*
+    widgets->a_star_radio = gtk_check_button_new_with_label("A* (Fast, Optimized)");
+    widgets->bidirectional_dijkstra_radio = gtk_check_button_new_with_label("Bidirectional Dijkstra");
+    widgets->bidirectional_a_star_radio = gtk_check_button_new_with_label("Bidirectional A*");
+    gtk_check_button_set_group(GTK_CHECK_BUTTON(widgets->a_star_radio), GTK_CHECK_BUTTON(widgets->dijkstra_radio));
+    gtk_check_button_set_group(GTK_CHECK_BUTTON(widgets->bidirectional_dijkstra_radio), GTK_CHECK_BUTTON(widgets->dijkstra_radio));
+    gtk_check_button_set_group(GTK_CHECK_BUTTON(widgets->bidirectional_a_star_radio), GTK_CHECK_BUTTON(widgets->dijkstra_radio));
+    gtk_check_button_set_active(GTK_CHECK_BUTTON(widgets->a_star_radio), TRUE); // Default to A*
     gtk_box_append(GTK_BOX(algo_box), widgets->dijkstra_radio);
-    gtk_box_append(GTK_BOX(algo_box), a_star_radio);
+    gtk_box_append(GTK_BOX(algo_box), widgets->a_star_radio);
+    gtk_box_append(GTK_BOX(algo_box), widgets->bidirectional_dijkstra_radio);
+    gtk_box_append(GTK_BOX(algo_box), widgets->bidirectional_a_star_radio);
+
+    // Heat map of distances from the start node
+    widgets->heat_map_check = gtk_check_button_new_with_label("Show distances from start (heat map)");
+    g_signal_connect(widgets->heat_map_check, "toggled", G_CALLBACK(on_heat_map_toggled), widgets);
+    gtk_box_append(GTK_BOX(controls_box), widgets->heat_map_check);
+
+    // Ranked alternatives to the shortest route
+    widgets->alternatives_check = gtk_check_button_new_with_label("Show alternative routes");
+    gtk_box_append(GTK_BOX(controls_box), widgets->alternatives_check);
+
+    // Area within walking distance of the start node
+    GtkWidget* reach_box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 5);
+    widgets->reach_check = gtk_check_button_new_with_label("Show area within");
+    widgets->reach_spin = gtk_spin_button_new_with_range(50, 5000, 50);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(widgets->reach_spin), REACH_DEFAULT_METRES);
+    g_signal_connect(widgets->reach_check, "toggled", G_CALLBACK(on_reach_area_changed), widgets);
+    g_signal_connect(widgets->reach_spin, "value-changed", G_CALLBACK(on_reach_area_changed), widgets);
+    gtk_box_append(GTK_BOX(reach_box), widgets->reach_check);
+    gtk_box_append(GTK_BOX(reach_box), widgets->reach_spin);
+    gtk_box_append(GTK_BOX(reach_box), gtk_label_new("m of start"));
+    gtk_box_append(GTK_BOX(controls_box), reach_box);
 
     // Find Path Button
     GtkWidget* find_button = gtk_button_new_with_label("Find Shortest Path");
@@ -398,11 +687,16 @@ static void on_app_activate(GtkApplication* app, gpointer user_data) {
     gtk_box_append(GTK_BOX(controls_box), GTK_WIDGET(widgets->status_label));
     
     // Scrollable Node List
-    GtkWidget* list_label = gtk_label_new("Available Nodes:");
+    GtkWidget* list_label = gtk_label_new("Available Nodes (or click the map):");
     gtk_widget_set_halign(list_label, GTK_ALIGN_START);
     gtk_widget_set_margin_top(list_label, 15);
     gtk_box_append(GTK_BOX(controls_box), list_label);
 
+    widgets->node_search = GTK_SEARCH_ENTRY(gtk_search_entry_new());
+    g_object_set(widgets->node_search, "placeholder-text", "Search by name", NULL);
+    g_signal_connect(widgets->node_search, "search-changed", G_CALLBACK(on_node_search_changed), widgets);
+    gtk_box_append(GTK_BOX(controls_box), GTK_WIDGET(widgets->node_search));
+
     GtkWidget* list_scroll_window = gtk_scrolled_window_new();
     gtk_widget_set_vexpand(list_scroll_window, TRUE); // Allow list to fill space
     gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(list_scroll_window), GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
@@ -420,6 +714,11 @@ static void on_app_activate(GtkApplication* app, gpointer user_data) {
     gtk_widget_set_vexpand(GTK_WIDGET(widgets->drawing_area), TRUE);
     gtk_drawing_area_set_draw_func(widgets->drawing_area, on_draw, widgets, NULL);
     gtk_paned_set_end_child(GTK_PANED(paned), GTK_WIDGET(widgets->drawing_area));
+
+    // Clicking the map picks the nearest node as start, then end
+    GtkGesture* click = gtk_gesture_click_new();
+    g_signal_connect(click, "pressed", G_CALLBACK(on_map_pressed), widgets);
+    gtk_widget_add_controller(GTK_WIDGET(widgets->drawing_area), GTK_EVENT_CONTROLLER(click));
     gtk_paned_set_resize_end_child(GTK_PANED(paned), TRUE);
     gtk_paned_set_shrink_end_child(GTK_PANED(paned), FALSE);
 
@@ -4,6 +4,12 @@
  
  #include "graph.h"
  #include "algorithms.h"
+ #include "ch.h"
+ #include "landmarks.h"
+ #include "apsp.h"
+ #include "spatial.h"
+ #include "nameindex.h"
+ #include "timeprofile.h"
  
  // Helper function to read a valid integer choice
  int get_int_choice(int max_choice) {
@@ -21,15 +27,60 @@
      return choice;
  }
  
- // Helper function to get a valid node id
- int get_node_id(int max_id) {
+ // Helper function to read a time of day as "HH:MM"; returns seconds since midnight, or -1
+ double get_time_of_day(void) {
+     char input[256];
+     int hours, minutes;
+ 
+     if (!fgets(input, sizeof(input), stdin)) {
+         return -1; // EOF or read error
+     }
+     if (sscanf(input, "%d:%d", &hours, &minutes) != 2 || hours < 0 || hours > 23 || minutes < 0 || minutes > 59) {
+         return -1;
+     }
+     return hours * 3600.0 + minutes * 60.0;
+ }
+ 
+ // Helper function to get a valid node id, typed directly, by name, or as
+ // "latitude,longitude" snapped to the nearest node
+ int get_node_id(const Graph* graph, const SpatialIndex* spatial, const NameIndex* names, int max_id) {
      char input[256];
      int node_id = -1;
  
      if (!fgets(input, sizeof(input), stdin)) {
          return -1; // EOF or read error
      }
-     node_id = (int)strtol(input, NULL, 10);
+     double latitude, longitude;
+     if (spatial && sscanf(input, "%lf , %lf", &latitude, &longitude) == 2) {
+         double distance_km;
+         node_id = spatial_nearest(spatial, latitude, longitude, &distance_km);
+         if (node_id != -1) {
+             printf("  Nearest node: %d (%s), %.0f m away\n", node_id, get_node_name(graph, node_id), distance_km * 1000.0);
+         }
+         return node_id;
+     }
+     char* end;
+     node_id = (int)strtol(input, &end, 10);
+ 
+     if (end == input && names) {
+         // Not a number: look the text up as a node name
+         input[strcspn(input, "\r\n")] = '\0';
+         const char* name = input + strspn(input, " \t");
+         node_id = name_index_find(names, name);
+         if (node_id != -1) {
+             printf("  Matched node: %d (%s)\n", node_id, get_node_name(graph, node_id));
+             return node_id;
+         }
+         int suggestions[5];
+         int count = name_index_complete(names, name, 5, suggestions);
+         if (count > 0) {
+             printf("  Did you mean:\n");
+             for (int i = 0; i < count; i++) {
+                 printf("    [%d] %s\n", suggestions[i], get_node_name(graph, suggestions[i]));
+             }
+         }
+         return -1;
+     }
  
      if (node_id < 0 || node_id > max_id) {
          return -1; // Invalid node
@@ -65,25 +116,35 @@
  
      // 2. Load Road Network 
      printf("\nAttempting to load '%s'...\n", chosen_map_file);
-     Graph* road_network = create_graph(250); 
+     Graph* road_network = create_graph(GRAPH_DEFAULT_CAPACITY); 
      if (!road_network || !load_road_network(road_network, chosen_map_file)) {
-         fprintf(stderr, "Failed to load road network. Make sure the file exists and capacity is sufficient.\n");
+         fprintf(stderr, "Failed to load road network. Make sure the file exists and is a valid map.\n");
          if (road_network) destroy_graph(road_network);
          return 1;
      }
      printf("Map loaded successfully. (%d nodes)\n", get_node_count(road_network));
      print_graph(road_network);
+     SpatialIndex* spatial = spatial_index_build(road_network);
+     NameIndex* names = name_index_build(road_network);
      
      // 3. Select Algorithm
      printf("\nChoose a pathfinding algorithm:\n");
      printf("  1. Dijkstra (Guaranteed shortest path)\n");
      printf("  2. A* (Optimized, usually faster)\n");
-     printf("Enter choice (1-2): ");
+     printf("  3. Bidirectional Dijkstra (Searches from both ends)\n");
+     printf("  4. Bidirectional A* (Both ends, guided)\n");
+     printf("  5. Contraction Hierarchies (Preprocessed, fastest queries)\n");
+     printf("  6. A* with Landmarks (ALT, tighter heuristic)\n");
+     printf("  7. All-Pairs Table (Precomputed, small maps only)\n");
+     printf("  8. Time-Dependent A* (Walking time at a departure time)\n");
+     printf("Enter choice (1-8): ");
  
-     int algo_choice = get_int_choice(2);
+     int algo_choice = get_int_choice(8);
  
      if (algo_choice == -1) {
          fprintf(stderr, "Invalid algorithm choice.\n");
+         spatial_index_destroy(spatial);
+         name_index_destroy(names);
          destroy_graph(road_network);
          return 1;
      }
@@ -94,38 +155,102 @@
      int max_node_id = get_node_count(road_network) - 1;
  
      printf("\n--- Enter Route Details ---\n");
-     printf("Available Nodes: 0 to %d\n", max_node_id);
+     printf("Available Nodes: 0 to %d (or enter a name, or latitude,longitude for the nearest node)\n", max_node_id);
  
      while (start_node == -1) {
          printf("Enter start node: ");
-         start_node = get_node_id(max_node_id);
+         start_node = get_node_id(road_network, spatial, names, max_node_id);
          if (start_node == -1) {
-             fprintf(stderr, "  Invalid ID. Please enter a number between 0 and %d.\n", max_node_id);
+             fprintf(stderr, "  Invalid node. Please enter a number between 0 and %d, a name, or latitude,longitude.\n", max_node_id);
          }
      }
  
      while (destination_node == -1) {
          printf("Enter destination node: ");
-         destination_node = get_node_id(max_node_id);
+         destination_node = get_node_id(road_network, spatial, names, max_node_id);
          if (destination_node == -1) {
-             fprintf(stderr, "  Invalid ID. Please enter a number between 0 and %d.\n", max_node_id);
+             fprintf(stderr, "  Invalid node. Please enter a number between 0 and %d, a name, or latitude,longitude.\n", max_node_id);
+         }
+     }
+ 
+     double departure_time = -1;
+     while (algo_choice == 8 && departure_time < 0) {
+         printf("Enter departure time (HH:MM): ");
+         departure_time = get_time_of_day();
+         if (departure_time < 0) {
+             fprintf(stderr, "  Invalid time. Please enter hours 00-23 and minutes 00-59, e.g. 08:55.\n");
          }
      }
  
      // 5. Calculate Route 
      PathResult route_result = { .found = false };
-     
-     if (algo_choice == 1) {
-         printf("\nCalculating route (Dijkstra) from Node %d to Node %d...\n", start_node, destination_node);
-         route_result = dijkstra_shortest_path(road_network, start_node, destination_node);
+     double arrival_time = -1;
+ 
+     if (algo_choice == 5) {
+         printf("\nPreprocessing contraction hierarchy...\n");
+         ContractionHierarchy* hierarchy = ch_build(road_network);
+         if (hierarchy) {
+             printf("Hierarchy ready (%d shortcuts).\n", hierarchy->num_shortcuts);
+             printf("Calculating route (Contraction Hierarchies) from Node %d to Node %d...\n", start_node, destination_node);
+             route_result = ch_shortest_path(hierarchy, start_node, destination_node);
+             ch_destroy(hierarchy);
+         }
+     } else if (algo_choice == 6) {
+         // Landmark tables are cached next to the map and rebuilt if the map changed
+         char landmark_file[300];
+         snprintf(landmark_file, sizeof(landmark_file), "%s.landmarks", chosen_map_file);
+         LandmarkSet* landmarks = landmarks_load(road_network, landmark_file);
+         if (!landmarks) {
+             printf("\nSelecting landmarks...\n");
+             landmarks = landmarks_build(road_network, 8, LANDMARKS_AVOID);
+             if (landmarks && landmarks_save(landmarks, landmark_file)) {
+                 printf("Landmark tables saved to '%s'.\n", landmark_file);
+             }
+         }
+         if (landmarks) {
+             printf("\nCalculating route (ALT, %d landmarks) from Node %d to Node %d...\n",
+                    landmarks->num_landmarks, start_node, destination_node);
+             route_result = alt_shortest_path(road_network, landmarks, start_node, destination_node);
+             landmarks_destroy(landmarks);
+         }
+     } else if (algo_choice == 7) {
+         // Tables are cached in "<map>.apsp" and rebuilt when the map file changes
+         printf("\nLoading all-pairs tables...\n");
+         DistanceMatrix* matrix = apsp_load_or_build(road_network, chosen_map_file, 0);
+         if (matrix) {
+             printf("Calculating route (All-Pairs Table) from Node %d to Node %d...\n", start_node, destination_node);
+             route_result = apsp_shortest_path(matrix, road_network, start_node, destination_node);
+             apsp_destroy(matrix);
+         }
+     } else if (algo_choice == 8) {
+         // Time-of-day profiles are read from the map's optional profile section
+         TimeProfiles* profiles = time_profiles_load(road_network, chosen_map_file);
+         if (profiles) {
+             printf("\nCalculating route (Time-Dependent A*, %d profiles) from Node %d to Node %d...\n",
+                    profiles->num_profiles - 1, start_node, destination_node);
+             route_result = td_a_star_shortest_path(road_network, profiles, start_node, destination_node,
+                                                    departure_time, &arrival_time);
+             time_profiles_destroy(profiles);
+         }
      } else {
-         printf("\nCalculating route (A*) from Node %d to Node %d...\n", start_node, destination_node);
-         route_result = a_star_shortest_path(road_network, start_node, destination_node);
+         const SearchAlgorithm algorithms[] = {
+             ALGO_DIJKSTRA, ALGO_A_STAR, ALGO_BIDIRECTIONAL_DIJKSTRA, ALGO_BIDIRECTIONAL_A_STAR
+         };
+         SearchAlgorithm algorithm = algorithms[algo_choice - 1];
+ 
+         printf("\nCalculating route (%s) from Node %d to Node %d...\n",
+                search_algorithm_name(algorithm), start_node, destination_node);
+         route_result = find_shortest_path(road_network, algorithm, start_node, destination_node);
      }
      
      if (route_result.found) {
          printf("Route found!\n");
          print_path_result(&route_result, road_network);
+         if (arrival_time >= 0) {
+             int arrival_minute = (int)(arrival_time / 60.0 + 0.5) % (24 * 60);
+             printf("Arrival: %02d:%02d (%.1f min walk)\n", arrival_minute / 60, arrival_minute % 60,
+                    (arrival_time - departure_time) / 60.0);
+         }
      } else {
          printf("No route found to the destination!\n");
      }
@@ -133,6 +258,8 @@
      // 6. Cleanup
      printf("\nCleaning up resources...\n");
      free_path_result(&route_result);
+     spatial_index_destroy(spatial);
+     name_index_destroy(names);
      destroy_graph(road_network);
  
      printf("Program finished.\n");
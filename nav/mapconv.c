@@ -0,0 +1,41 @@
+/*
+ * Map Converter - Turns a text road network into the memory-mapped binary format.
+ *
+ * Usage: mapconv <input.txt> <output.nmap>
+ *        mapconv --verify <map.nmap>
+ *
+ * Loading a binary map skips the checksum, so a converted file is verified
+ * here once, right after it is written.
+ */
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+
+ #include "graph.h"
+
+ int main(int argc, char** argv) {
+     if (argc == 3 && strcmp(argv[1], "--verify") == 0) {
+         bool ok = verify_binary_map(argv[2]);
+         if (ok) printf("'%s' is a valid binary map.\n", argv[2]);
+         return ok ? 0 : 1;
+     }
+     if (argc != 3) {
+         fprintf(stderr, "Usage: %s <input.txt> <output.nmap>\n       %s --verify <map.nmap>\n", argv[0], argv[0]);
+         return 1;
+     }
+
+     Graph* graph = create_graph(GRAPH_DEFAULT_CAPACITY);
+     if (!graph || !load_road_network(graph, argv[1])) {
+         fprintf(stderr, "Failed to load '%s'.\n", argv[1]);
+         destroy_graph(graph);
+         return 1;
+     }
+
+     bool ok = save_binary_map(graph, argv[2]) && verify_binary_map(argv[2]);
+     if (ok) {
+         printf("Wrote '%s' (%d nodes, %d directed edges).\n", argv[2], get_node_count(graph), graph->num_edges);
+     }
+     destroy_graph(graph);
+     return ok ? 0 : 1;
+ }
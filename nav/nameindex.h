@@ -0,0 +1,35 @@
+/*
+ * Name Index - Case-insensitive node lookup by name and prefix completion.
+ */
+
+ #ifndef NAMEINDEX_H
+ #define NAMEINDEX_H
+
+ #include "graph.h"
+
+ typedef struct {
+     const char* key;         // Folded node name
+     int node_id;
+ } NameEntry;
+
+ typedef struct {
+     int num_entries;
+     NameEntry* entries;      // Sorted by key, then node ID
+     Arena arena;             // Folded copies of the names, one per distinct name
+ } NameIndex;
+
+ // Lifecycle Management. The index copies the names, so it must be rebuilt
+ // after nodes are added.
+ NameIndex* name_index_build(const Graph* graph);
+ void name_index_destroy(NameIndex* index);
+
+ // Names match ignoring ASCII case, with '_' and ' ' treated alike, so
+ // "santoshanand library" finds "Santoshanand_Library".
+ //
+ // name_index_find() returns the lowest node ID with that name, or -1.
+ // name_index_complete() writes up to max_results nodes whose names start with
+ // prefix, in name order, and returns how many it wrote (-1 on error).
+ int name_index_find(const NameIndex* index, const char* name);
+ int name_index_complete(const NameIndex* index, const char* prefix, int max_results, int* node_ids);
+
+ #endif // NAMEINDEX_H
@@ -0,0 +1,36 @@
+/*
+ * Shortest Path Trees - Every distance and route from one source.
+ */
+
+ #ifndef SPT_H
+ #define SPT_H
+
+ #include "graph.h"
+ #include "algorithms.h"
+
+ // All arrays live in one allocation, laid out distances, predecessors, order.
+ typedef struct {
+     int source_id;
+     int num_nodes;
+     int num_reached;         // Nodes reachable from the source, including it
+     double* distances;       // [v] = d(source, v), DBL_MAX if unreachable
+     int* predecessors;       // [v] = previous node on the route to v, -1 at the source and if unreachable
+     int* order;              // The num_reached reachable nodes by distance; parents come before children
+     uint64_t graph_version;  // Graph version the tree is current for
+ } ShortestPathTree;
+
+ // Lifecycle Management. One full Dijkstra search from source_id.
+ ShortestPathTree* shortest_path_tree(const Graph* graph, int source_id);
+ ShortestPathTree* shortest_path_tree_ws(const Graph* graph, SearchWorkspace* workspace, int source_id);
+ void shortest_path_tree_destroy(ShortestPathTree* tree);
+
+ // Brings the tree up to date after the graph changed: a repair from the
+ // change log when it reaches back far enough, otherwise a fresh search.
+ bool shortest_path_tree_update(ShortestPathTree* tree, const Graph* graph, SearchWorkspace* workspace);
+
+ // Queries (no search). The path is source first, as from dijkstra_shortest_path().
+ double shortest_path_tree_distance(const ShortestPathTree* tree, int target_id);
+ PathResult shortest_path_tree_path(const ShortestPathTree* tree, int target_id);
+ double shortest_path_tree_max_distance(const ShortestPathTree* tree);
+
+ #endif // SPT_H
@@ -0,0 +1,39 @@
+/*
+ * String Table - Interned strings referenced by 32-bit IDs.
+ */
+
+ #ifndef STRTAB_H
+ #define STRTAB_H
+
+ #include "arena.h"
+ #include <stdbool.h>
+ #include <stddef.h>
+ #include <stdint.h>
+
+ typedef struct {
+     const char** strings;    // id -> text
+     uint32_t* hashes;        // id -> hash, kept so growing never rehashes text
+     int count;
+     int capacity;
+
+     int* slots;              // Open addressing: id + 1, 0 when empty
+     int slot_capacity;       // Power of two, at most half full
+
+     Arena arena;             // Copies made by strtab_intern()
+ } StringTable;
+
+ // Lifecycle Management
+ bool strtab_init(StringTable* table);
+ void strtab_free(StringTable* table);
+
+ // Returns the ID of text, adding it on first use; -1 if out of memory.
+ // strtab_intern() copies the bytes, strtab_intern_static() keeps the pointer,
+ // so that text must outlive the table.
+ int strtab_intern(StringTable* table, const char* text, size_t length);
+ int strtab_intern_static(StringTable* table, const char* text);
+
+ // Lookup
+ int strtab_find(const StringTable* table, const char* text, size_t length);
+ const char* strtab_get(const StringTable* table, int id);
+
+ #endif // STRTAB_H
@@ -0,0 +1,135 @@
+/*
+ * Distance Table Implementation
+ *
+ * Each source runs one Dijkstra that stops as soon as every target has been
+ * settled, instead of one search per (source, target) pair. Settled status is
+ * checked through a cursor over the target list that only moves forward, so
+ * the stopping test costs O(num_targets) per source in total.
+ */
+
+ #include "table.h"
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <float.h>
+
+ #define INFINITY_VAL DBL_MAX
+
+ static bool valid_nodes(const Graph* graph, const int* ids, int count, const char* caller) {
+     for (int i = 0; i < count; i++) {
+         if (!is_valid_node(graph, ids[i])) {
+             fprintf(stderr, "[Table Error] %s: Invalid node ID %d at index %d\n", caller, ids[i], i);
+             return false;
+         }
+     }
+     return true;
+ }
+
+ bool one_to_many_distances_ws(const Graph* graph, SearchWorkspace* ws, int source_id,
+                               const int* targets, int num_targets, double* distances, int* predecessors) {
+     if (!ws || !distances || (num_targets > 0 && !targets)) {
+         fprintf(stderr, "[Table Error] one_to_many_distances: Workspace, targets or output is NULL\n");
+         return false;
+     }
+     if (!is_graph_frozen(graph)) {
+         fprintf(stderr, "[Table Error] one_to_many_distances: Graph is NULL or not frozen (call graph_freeze)\n");
+         return false;
+     }
+     if (!is_valid_node(graph, source_id) || !valid_nodes(graph, targets, num_targets, "one_to_many_distances")) {
+         return false;
+     }
+     int n = get_node_count(graph);
+     if (!search_workspace_begin(ws, n, false)) return false;
+
+     SearchSide* side = &ws->forward;
+     unsigned int gen = ws->generation;
+     side_touch(side, gen, source_id);
+     side->distance[source_id] = 0.0;
+     heap_push_or_decrease(&side->heap, source_id, 0.0);
+
+     int pending = 0;   // targets[0 .. pending) are settled
+     while (!heap_is_empty(&side->heap)) {
+         int current_id = heap_pop_min(&side->heap, NULL);
+         side_settle(ws, side, current_id);
+         while (pending < num_targets && side_is_settled(side, gen, targets[pending])) pending++;
+         if (pending == num_targets) break;
+
+         for (int e = graph->edge_offsets[current_id]; e < graph->edge_offsets[current_id + 1]; e++) {
+             int neighbor_id = graph->edge_targets[e];
+             if (side_is_settled(side, gen, neighbor_id)) continue;
+             side_touch(side, gen, neighbor_id);
+             double new_dist = side->distance[current_id] + graph->edge_weights[e];
+             if (new_dist < side->distance[neighbor_id]) {
+                 side->distance[neighbor_id] = new_dist;
+                 side->predecessor[neighbor_id] = current_id;
+                 heap_push_or_decrease(&side->heap, neighbor_id, new_dist);
+             }
+         }
+     }
+
+     for (int t = 0; t < num_targets; t++) {
+         int target_id = targets[t];
+         distances[t] = side_is_settled(side, gen, target_id) ? side->distance[target_id] : INFINITY_VAL;
+     }
+     if (predecessors) {
+         // Only settled labels are final; the rest of the frontier is left out
+         for (int v = 0; v < n; v++) {
+             predecessors[v] = side_is_settled(side, gen, v) ? side->predecessor[v] : -1;
+         }
+     }
+     return true;
+ }
+
+ bool distance_table_fill(const Graph* graph, const int* sources, int num_sources,
+                          const int* targets, int num_targets, double* distances, int* predecessors) {
+     if (!graph || (num_sources > 0 && !sources) || num_sources < 0 || num_targets < 0) {
+         fprintf(stderr, "[Table Error] distance_table_fill: Graph or sources is NULL\n");
+         return false;
+     }
+     if (!valid_nodes(graph, sources, num_sources, "distance_table_fill")) return false;
+
+     int n = get_node_count(graph);
+     SearchWorkspace* ws = search_workspace_create(n);
+     if (!ws) return false;
+
+     bool ok = true;
+     for (int s = 0; s < num_sources && ok; s++) {
+         ok = one_to_many_distances_ws(graph, ws, sources[s], targets, num_targets,
+                                       distances + (size_t)s * num_targets,
+                                       predecessors ? predecessors + (size_t)s * n : NULL);
+     }
+     search_workspace_destroy(ws);
+     return ok;
+ }
+
+ DistanceTable* distance_table_build(const Graph* graph, const int* sources, int num_sources,
+                                     const int* targets, int num_targets, bool with_predecessors) {
+     if (!graph || num_sources < 0 || num_targets < 0) return NULL;
+     int n = get_node_count(graph);
+     size_t distance_cells = (size_t)num_sources * num_targets;
+     size_t predecessor_cells = with_predecessors ? (size_t)num_sources * n : 0;
+
+     // Header, distances and predecessors share one allocation
+     DistanceTable* table = malloc(sizeof(DistanceTable) + distance_cells * sizeof(double)
+                                   + predecessor_cells * sizeof(int));
+     if (!table) {
+         fprintf(stderr, "[Table Error] distance_table_build: Failed to allocate a %d x %d table\n",
+                 num_sources, num_targets);
+         return NULL;
+     }
+     table->num_sources = num_sources;
+     table->num_targets = num_targets;
+     table->num_nodes = n;
+     table->distances = (double*)(table + 1);
+     table->predecessors = with_predecessors ? (int*)(table->distances + distance_cells) : NULL;
+
+     if (!distance_table_fill(graph, sources, num_sources, targets, num_targets,
+                              table->distances, table->predecessors)) {
+         free(table);
+         return NULL;
+     }
+     return table;
+ }
+
+ void distance_table_destroy(DistanceTable* table) {
+     free(table);
+ }
@@ -0,0 +1,34 @@
+/*
+ * Distance Tables - One-to-many and many-to-many shortest path distances.
+ */
+
+ #ifndef TABLE_H
+ #define TABLE_H
+
+ #include "graph.h"
+ #include "algorithms.h"
+
+ typedef struct {
+     int num_sources;
+     int num_targets;
+     int num_nodes;
+     double* distances;       // [s * num_targets + t] = d(sources[s], targets[t]), DBL_MAX if unreachable
+     int* predecessors;       // Optional [s * num_nodes + v] search tree of sources[s], -1 outside it
+ } DistanceTable;
+
+ // One search per source that stops once every target is settled.
+ // distances must hold num_sources * num_targets values; predecessors may be
+ // NULL or hold num_sources * num_nodes values.
+ bool distance_table_fill(const Graph* graph, const int* sources, int num_sources,
+                          const int* targets, int num_targets, double* distances, int* predecessors);
+
+ // Convenience form owning one buffer for both tables
+ DistanceTable* distance_table_build(const Graph* graph, const int* sources, int num_sources,
+                                     const int* targets, int num_targets, bool with_predecessors);
+ void distance_table_destroy(DistanceTable* table);
+
+ // Single-source variant with a caller-owned workspace
+ bool one_to_many_distances_ws(const Graph* graph, SearchWorkspace* workspace, int source_id,
+                               const int* targets, int num_targets, double* distances, int* predecessors);
+
+ #endif // TABLE_H
@@ -0,0 +1,574 @@
+/*
+ * Text Map Parser Implementation
+ *
+ * The file is streamed through a large buffer. Each refill is cut after its
+ * last newline and split into one block of whole lines per worker. Workers
+ * parse their block into records with hand-written number parsers and count
+ * its lines; the main thread then fixes up line numbers and adds the records
+ * to the graph in file order. Sections are delimited only by the counts in
+ * the header, so when one ends inside a batch the rest of that batch is
+ * parsed again as the next section.
+ */
+
+ #define _POSIX_C_SOURCE 200809L
+
+ #include "textmap.h"
+ #include "utils.h"
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <limits.h>
+ #include <stdint.h>
+ #include <pthread.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+
+ #define TEXTMAP_BLOCK_SIZE (1 << 20)       // Bytes of text per worker and batch
+ #define TEXTMAP_MIN_BLOCK_SIZE (64 << 10)   // Smaller batches are not worth a thread
+ #define TEXTMAP_MAX_THREADS 64
+ #define TEXTMAP_WEIGHT_BATCH 256           // Auto-weighted edges per haversine_batch() call
+
+ typedef enum {
+     SECTION_HEADER,
+     SECTION_NODES,
+     SECTION_EDGES,
+     SECTION_DONE
+ } MapSection;
+
+ // One parsed data line. Names point into the read buffer and stay valid
+ // until the next refill.
+ typedef struct {
+     long line;               // Index within the block, absolute once fixed up
+     size_t end;              // Buffer offset just past the line
+     const char* error;       // NULL when the line parsed
+     int column;
+     union {
+         struct {
+             double latitude;
+             double longitude;
+             const char* name;
+             int name_length;
+         } node;
+         struct {
+             int source_id;
+             int destination_id;
+             double weight;
+         } edge;
+     };
+ } MapRecord;
+
+ typedef struct {
+     const char* buffer;
+     size_t begin;            // Offsets of the block's whole lines in buffer
+     size_t end;
+     MapSection section;
+     const Graph* graph;      // Read-only while workers run (edge validation, auto weights)
+     MapRecord* records;
+     int count;
+     int capacity;
+     long lines;
+     bool out_of_memory;
+ } MapBlock;
+
+ typedef struct {
+     FILE* file;
+     char* data;
+     size_t capacity;
+     size_t size;
+     bool eof;
+ } ChunkReader;
+
+ // Number Parsing
+ static const double exact_powers_of_ten[] = {
+     1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+ };
+
+ static inline bool is_blank(char c) {
+     return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+ }
+
+ static inline bool is_digit(char c) {
+     return c >= '0' && c <= '9';
+ }
+
+ static inline const char* skip_blanks(const char* p, const char* end) {
+     while (p < end && is_blank(*p)) p++;
+     return p;
+ }
+
+ static inline bool at_token_end(const char* p, const char* end) {
+     return p == end || is_blank(*p);
+ }
+
+ static bool parse_int(const char** cursor, const char* end, int* value) {
+     const char* p = *cursor;
+     bool negative = false;
+     if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+     if (p == end || !is_digit(*p)) return false;
+
+     long long result = 0;
+     for (; p < end && is_digit(*p); p++) {
+         result = result * 10 + (*p - '0');
+         if (result > (long long)INT_MAX + 1) return false;
+     }
+     if (!at_token_end(p, end)) return false;
+     if (negative) result = -result;
+     if (result > INT_MAX) return false;
+
+     *value = (int)result;
+     *cursor = p;
+     return true;
+ }
+
+ // Decimal to double without locale lookups. Up to 19 significant digits are
+ // gathered into an integer; when it fits in 53 bits and the power of ten is
+ // exact (Clinger's fast path) one multiply or divide rounds correctly.
+ // Anything else falls back to strtod.
+ static bool parse_double(const char** cursor, const char* end, double* value) {
+     const char* start = *cursor;
+     const char* p = start;
+     bool negative = false;
+     if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+
+     uint64_t mantissa = 0;
+     int digits = 0;
+     int exponent = 0;
+     bool any_digits = false;
+     bool truncated = false;
+     for (; p < end && is_digit(*p); p++) {
+         any_digits = true;
+         if (digits < 19) {
+             mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+             if (mantissa) digits++;
+         } else {
+             exponent++;
+             truncated = truncated || *p != '0';
+         }
+     }
+     if (p < end && *p == '.') {
+         for (p++; p < end && is_digit(*p); p++) {
+             any_digits = true;
+             if (digits < 19) {
+                 mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                 if (mantissa) digits++;
+                 exponent--;
+             } else {
+                 truncated = truncated || *p != '0';
+             }
+         }
+     }
+     if (!any_digits) return false;
+
+     if (p < end && (*p == 'e' || *p == 'E')) {
+         p++;
+         bool negative_exponent = false;
+         if (p < end && (*p == '-' || *p == '+')) negative_exponent = *p++ == '-';
+         if (p == end || !is_digit(*p)) return false;
+         int written = 0;
+         for (; p < end && is_digit(*p); p++) {
+             if (written < 100000) written = written * 10 + (*p - '0');
+         }
+         exponent += negative_exponent ? -written : written;
+     }
+     if (!at_token_end(p, end)) return false;
+
+     double result;
+     if (!truncated && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+         result = (double)mantissa;
+         result = exponent < 0 ? result / exact_powers_of_ten[-exponent] : result * exact_powers_of_ten[exponent];
+         if (negative) result = -result;
+     } else {
+         char token[64];
+         size_t length = (size_t)(p - start);
+         if (length >= sizeof(token)) return false;
+         memcpy(token, start, length);
+         token[length] = '\0';
+         result = strtod(token, NULL);
+     }
+     *value = result;
+     *cursor = p;
+     return true;
+ }
+
+ // Line Parsing
+ static void set_error(MapRecord* record, const char* line, const char* at, const char* message) {
+     record->error = message;
+     record->column = (int)(at - line) + 1;
+ }
+
+ static void parse_node_line(MapRecord* record, const char* line, const char* end) {
+     const char* p = skip_blanks(line, end);
+     if (!parse_double(&p, end, &record->node.latitude)) {
+         set_error(record, line, p, "expected a latitude");
+         return;
+     }
+     p = skip_blanks(p, end);
+     if (!parse_double(&p, end, &record->node.longitude)) {
+         set_error(record, line, p, "expected a longitude");
+         return;
+     }
+
+     // The name is the rest of the line, possibly empty
+     p = skip_blanks(p, end);
+     const char* name_end = end;
+     while (name_end > p && is_blank(name_end[-1])) name_end--;
+     record->node.name = p;
+     record->node.name_length = (int)(name_end - p);
+ }
+
+ static void parse_edge_line(MapRecord* record, const Graph* graph, const char* line, const char* end) {
+     int num_nodes = get_node_count(graph);
+     const char* p = skip_blanks(line, end);
+     const char* token = p;
+     if (!parse_int(&p, end, &record->edge.source_id)) {
+         set_error(record, line, token, "expected a source node ID");
+         return;
+     }
+     if (record->edge.source_id < 0 || record->edge.source_id >= num_nodes) {
+         set_error(record, line, token, "source node ID out of range");
+         return;
+     }
+     p = token = skip_blanks(p, end);
+     if (!parse_int(&p, end, &record->edge.destination_id)) {
+         set_error(record, line, token, "expected a destination node ID");
+         return;
+     }
+     if (record->edge.destination_id < 0 || record->edge.destination_id >= num_nodes) {
+         set_error(record, line, token, "destination node ID out of range");
+         return;
+     }
+
+     // Optional weight; zero, negative or missing means haversine distance,
+     // filled in for the whole block by fill_auto_weights()
+     double weight = 0.0;
+     p = token = skip_blanks(p, end);
+     if (p < end && !parse_double(&p, end, &weight)) {
+         set_error(record, line, token, "malformed weight");
+         return;
+     }
+     record->edge.weight = weight > 0 ? weight : 0.0;
+ }
+ 
+ // Pending haversine weights of an edge block, gathered into coordinate arrays
+ typedef struct {
+     double lat1[TEXTMAP_WEIGHT_BATCH];
+     double lon1[TEXTMAP_WEIGHT_BATCH];
+     double lat2[TEXTMAP_WEIGHT_BATCH];
+     double lon2[TEXTMAP_WEIGHT_BATCH];
+     double distances[TEXTMAP_WEIGHT_BATCH];
+     MapRecord* records[TEXTMAP_WEIGHT_BATCH];
+     int count;
+ } WeightBatch;
+ 
+ static void flush_weights(WeightBatch* batch) {
+     haversine_batch(batch->lat1, batch->lon1, batch->lat2, batch->lon2, batch->distances, batch->count);
+     for (int i = 0; i < batch->count; i++) batch->records[i]->edge.weight = batch->distances[i];
+     batch->count = 0;
+ }
+ 
+ static void fill_auto_weights(MapBlock* block) {
+     WeightBatch batch;
+     batch.count = 0;
+     const Graph* graph = block->graph;
+     for (int r = 0; r < block->count; r++) {
+         MapRecord* record = &block->records[r];
+         if (record->error || record->edge.weight > 0) continue;
+         int u = record->edge.source_id;
+         int v = record->edge.destination_id;
+         batch.lat1[batch.count] = graph->latitudes[u];
+         batch.lon1[batch.count] = graph->longitudes[u];
+         batch.lat2[batch.count] = graph->latitudes[v];
+         batch.lon2[batch.count] = graph->longitudes[v];
+         batch.records[batch.count++] = record;
+         if (batch.count == TEXTMAP_WEIGHT_BATCH) flush_weights(&batch);
+     }
+     if (batch.count > 0) flush_weights(&batch);
+ }
+ 
+ static MapRecord* block_next_record(MapBlock* block) {
+     if (block->count == block->capacity) {
+         int capacity = block->capacity > 0 ? block->capacity * 2 : 1024;
+         MapRecord* records = realloc(block->records, capacity * sizeof(MapRecord));
+         if (!records) {
+             block->out_of_memory = true;
+             return NULL;
+         }
+         block->records = records;
+         block->capacity = capacity;
+     }
+     MapRecord* record = &block->records[block->count++];
+     record->error = NULL;
+     record->column = 0;
+     return record;
+ }
+
+ static void* parse_block(void* arg) {
+     MapBlock* block = arg;
+     block->count = 0;
+     block->lines = 0;
+     block->out_of_memory = false;
+
+     const char* p = block->buffer + block->begin;
+     const char* stop = block->buffer + block->end;
+     while (p < stop) {
+         const char* newline = memchr(p, '\n', (size_t)(stop - p));
+         const char* line_end = newline ? newline : stop;
+         const char* next = newline ? newline + 1 : stop;
+         long line_index = block->lines++;
+
+         // Comments and blank lines carry no record
+         const char* first = skip_blanks(p, line_end);
+         if (first == line_end || *first == '#') {
+             p = next;
+             continue;
+         }
+         MapRecord* record = block_next_record(block);
+         if (!record) break;
+         record->line = line_index;
+         record->end = (size_t)(next - block->buffer);
+         if (block->section == SECTION_NODES) parse_node_line(record, p, line_end);
+         else parse_edge_line(record, block->graph, p, line_end);
+         p = next;
+     }
+     if (block->section == SECTION_EDGES) fill_auto_weights(block);
+     return NULL;
+ }
+
+ // Buffered Reading
+ // Moves the unconsumed tail to the front and tops the buffer up. Returns the
+ // length of the prefix made of whole lines (everything at end of file),
+ // 0 when the file is exhausted, SIZE_MAX if a line did not fit in memory.
+ static size_t reader_fill(ChunkReader* reader, size_t consumed) {
+     memmove(reader->data, reader->data + consumed, reader->size - consumed);
+     reader->size -= consumed;
+     for (;;) {
+         while (!reader->eof && reader->size < reader->capacity) {
+             size_t wanted = reader->capacity - reader->size;
+             size_t got = fread(reader->data + reader->size, 1, wanted, reader->file);
+             reader->size += got;
+             if (got < wanted) reader->eof = true;
+         }
+         if (reader->eof) return reader->size;
+
+         for (size_t i = reader->size; i > 0; i--) {
+             if (reader->data[i - 1] == '\n') return i;
+         }
+         // A single line longer than the buffer
+         char* data = realloc(reader->data, reader->capacity * 2);
+         if (!data) return SIZE_MAX;
+         reader->data = data;
+         reader->capacity *= 2;
+     }
+ }
+
+ static int worker_count(void) {
+     long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+     if (cpus < 1) return 1;
+     return cpus > TEXTMAP_MAX_THREADS ? TEXTMAP_MAX_THREADS : (int)cpus;
+ }
+
+ // Parses [begin, end) of the buffer as one section, in parallel when it is large
+ static int parse_batch(MapBlock* blocks, int max_blocks, const char* buffer, size_t begin, size_t end,
+                        MapSection section, const Graph* graph) {
+     size_t length = end - begin;
+     int num_blocks = (int)(length / TEXTMAP_MIN_BLOCK_SIZE) + 1;
+     if (num_blocks > max_blocks) num_blocks = max_blocks;
+
+     // Cut at the first newline after each even split point
+     size_t block_begin = begin;
+     for (int b = 0; b < num_blocks; b++) {
+         size_t block_end = b == num_blocks - 1 ? end : begin + length * (b + 1) / num_blocks;
+         if (block_end < block_begin) block_end = block_begin;
+         while (block_end < end && buffer[block_end - 1] != '\n') block_end++;
+         blocks[b].buffer = buffer;
+         blocks[b].begin = block_begin;
+         blocks[b].end = block_end;
+         blocks[b].section = section;
+         blocks[b].graph = graph;
+         block_begin = block_end;
+     }
+
+     pthread_t threads[TEXTMAP_MAX_THREADS];
+     bool started[TEXTMAP_MAX_THREADS] = { false };
+     for (int b = 1; b < num_blocks; b++) {
+         started[b] = pthread_create(&threads[b], NULL, parse_block, &blocks[b]) == 0;
+     }
+     parse_block(&blocks[0]);
+     for (int b = 1; b < num_blocks; b++) {
+         if (started[b]) pthread_join(threads[b], NULL);
+         else parse_block(&blocks[b]);
+     }
+     return num_blocks;
+ }
+
+ // Loading
+ typedef struct {
+     Graph* graph;
+     const char* filename;
+     MapSection section;
+     int expected_nodes;
+     int expected_edges;
+     int nodes_read;
+     int edges_read;
+     bool failed;
+ } MapLoad;
+
+ static void report(const MapLoad* load, long line, int column, const char* message) {
+     fprintf(stderr, "[Graph Error] load_road_network: %s:%ld:%d: %s\n", load->filename, line, column, message);
+ }
+
+ // Returns true if the line held the "num_nodes num_edges" header
+ static bool parse_header_line(MapLoad* load, const char* line, const char* end) {
+     const char* p = skip_blanks(line, end);
+     if (p == end || *p == '#') return false;
+     int nodes, edges;
+     if (!parse_int(&p, end, &nodes)) return false;
+     p = skip_blanks(p, end);
+     if (!parse_int(&p, end, &edges)) return false;
+     load->expected_nodes = nodes;
+     load->expected_edges = edges;
+     return true;
+ }
+
+ // Adds one record to the graph; returns true once its section is complete
+ static bool apply_record(MapLoad* load, const MapRecord* record) {
+     if (record->error) {
+         report(load, record->line, record->column, record->error);
+         return false;
+     }
+     if (load->section == SECTION_NODES) {
+         // Interning terminates the name, so add_node() only finds it again
+         int name_id = strtab_intern(&load->graph->names, record->node.name, record->node.name_length);
+         const char* name = graph_name(load->graph, name_id);
+         if (!name || add_node(load->graph, record->node.latitude, record->node.longitude, name) == -1) {
+             fprintf(stderr, "[Graph Error] load_road_network: Failed to add node.\n");
+             load->failed = true;
+             return true;
+         }
+         return ++load->nodes_read == load->expected_nodes;
+     }
+     if (!add_bidirectional_edge(load->graph, record->edge.source_id, record->edge.destination_id,
+                                 record->edge.weight, NULL)) {
+         fprintf(stderr, "[Graph Error] load_road_network: Failed to add edge (%d, %d).\n",
+                 record->edge.source_id, record->edge.destination_id);
+     }
+     return ++load->edges_read == load->expected_edges;
+ }
+
+ static MapSection next_section(const MapLoad* load, MapSection section) {
+     if (section == SECTION_NODES && load->expected_edges > 0) return SECTION_EDGES;
+     return SECTION_DONE;
+ }
+
+ bool load_text_map(Graph* graph, const char* filename) {
+     if (!graph || !filename) {
+         fprintf(stderr, "[Graph Error] load_road_network: Graph or filename is NULL.\n");
+         return false;
+     }
+     FILE* file = fopen(filename, "rb");
+     if (!file) {
+         fprintf(stderr, "[Graph Error] load_road_network: Could not open file '%s'.\n", filename);
+         return false;
+     }
+
+     int max_blocks = worker_count();
+     size_t capacity = (size_t)max_blocks * TEXTMAP_BLOCK_SIZE;
+     struct stat info;
+     if (fstat(fileno(file), &info) == 0 && (size_t)info.st_size + 1 < capacity) {
+         capacity = (size_t)info.st_size + 1;
+     }
+     if (capacity < 4096) capacity = 4096;
+
+     ChunkReader reader = { .file = file, .data = malloc(capacity), .capacity = capacity };
+     MapBlock* blocks = calloc(max_blocks, sizeof(MapBlock));
+     MapLoad load = { .graph = graph, .filename = filename, .section = SECTION_HEADER };
+     if (!reader.data || !blocks) {
+         fprintf(stderr, "[Graph Error] load_road_network: Failed to allocate read buffers.\n");
+         load.failed = true;
+     }
+
+     size_t consumed = 0;
+     long line_base = 1;   // Number of the line at the cursor
+     while (!load.failed && load.section != SECTION_DONE) {
+         size_t batch = reader_fill(&reader, consumed);
+         if (batch == SIZE_MAX) {
+             fprintf(stderr, "[Graph Error] load_road_network: %s:%ld: Line too long to buffer.\n", filename, line_base);
+             load.failed = true;
+             break;
+         }
+         if (batch == 0) break;
+
+         size_t cursor = 0;
+         while (cursor < batch && !load.failed && load.section != SECTION_DONE) {
+             if (load.section == SECTION_HEADER) {
+                 // Lines before the header that are not "num_nodes num_edges" are skipped
+                 const char* line = reader.data + cursor;
+                 const char* newline = memchr(line, '\n', batch - cursor);
+                 const char* line_end = newline ? newline : reader.data + batch;
+                 cursor = newline ? (size_t)(newline - reader.data) + 1 : batch;
+                 line_base++;
+                 if (!parse_header_line(&load, line, line_end)) continue;
+
+                 if (load.expected_nodes <= 0 || load.expected_edges < 0) {
+                     report(&load, line_base - 1, 1, "invalid node/edge count header");
+                     load.failed = true;
+                 } else if (!graph_reserve(graph, get_node_count(graph) + load.expected_nodes)) {
+                     load.failed = true;   // Pre-size from the header instead of growing node by node
+                 }
+                 load.section = SECTION_NODES;
+                 continue;
+             }
+
+             int num_blocks = parse_batch(blocks, max_blocks, reader.data, cursor, batch, load.section, graph);
+             bool section_complete = false;
+             long block_base = line_base;
+             for (int b = 0; b < num_blocks && !section_complete && !load.failed; b++) {
+                 if (blocks[b].out_of_memory) {
+                     fprintf(stderr, "[Graph Error] load_road_network: Out of memory while parsing.\n");
+                     load.failed = true;
+                     break;
+                 }
+                 for (int r = 0; r < blocks[b].count && !section_complete && !load.failed; r++) {
+                     MapRecord* record = &blocks[b].records[r];
+                     record->line += block_base;
+                     if (apply_record(&load, record)) {
+                         section_complete = true;
+                         cursor = record->end;
+                         line_base = record->line + 1;
+                     }
+                 }
+                 block_base += blocks[b].lines;
+             }
+             if (section_complete) {
+                 load.section = next_section(&load, load.section);
+             } else {
+                 cursor = batch;
+                 line_base = block_base;
+             }
+         }
+         consumed = batch;
+     }
+
+     if (!load.failed) {
+         if (load.section == SECTION_HEADER) {
+             fprintf(stderr, "[Graph Error] load_road_network: Failed to read node/edge count header from '%s'.\n", filename);
+             load.failed = true;
+         } else if (load.nodes_read != load.expected_nodes) {
+             fprintf(stderr, "[Graph Error] load_road_network: Expected %d nodes, but only read %d.\n",
+                     load.expected_nodes, load.nodes_read);
+             load.failed = true;
+         } else if (load.edges_read != load.expected_edges) {
+             fprintf(stderr, "[Graph Error] load_road_network: Expected %d edges, but only read %d.\n",
+                     load.expected_edges, load.edges_read);
+         }
+     }
+
+     if (blocks) {
+         for (int b = 0; b < max_blocks; b++) free(blocks[b].records);
+     }
+     free(blocks);
+     free(reader.data);
+     fclose(file);
+     return !load.failed;
+ }
@@ -1,9 +1,17 @@
 /*
  * Utility Functions Implementation
+ *
+ * haversine_batch() evaluates four pairs at a time with GCC vector
+ * extensions. Sine and cosine are the fdlibm kernels after a Cody-Waite
+ * reduction by pi/2, and asin is fdlibm's rational approximation, so every
+ * lane runs the same branch-free arithmetic. target_clones builds an AVX2
+ * copy and a baseline SSE2 copy and picks one when the program loads; other
+ * compilers and targets use the scalar loop.
  */
 
  #include "utils.h"
  #include <math.h>
+ #include <string.h>
  
  double haversine_distance(double lat1, double lon1, double lat2, double lon2) {
      double rad_lat1 = lat1 * (PI / 180.0);
@@ -17,4 +25,184 @@
                 sin(d_lon / 2) * sin(d_lon / 2);
      double c = 2 * asin(sqrt(a));
      return EARTH_RADIUS_KM * c;
- }
\ No newline at end of file
+ }
+ 
+ void unit_vector(double lat, double lon, double xyz[3]) {
+     double rad_lat = lat * (PI / 180.0);
+     double rad_lon = lon * (PI / 180.0);
+     xyz[0] = cos(rad_lat) * cos(rad_lon);
+     xyz[1] = cos(rad_lat) * sin(rad_lon);
+     xyz[2] = sin(rad_lat);
+ }
+ 
+ static void haversine_batch_scalar(const double* lat1, const double* lon1, const double* lat2, const double* lon2,
+                                    double* distances, size_t count) {
+     for (size_t i = 0; i < count; i++) {
+         distances[i] = haversine_distance(lat1[i], lon1[i], lat2[i], lon2[i]);
+     }
+ }
+ 
+ #if defined(__GNUC__) && defined(__x86_64__) && defined(__has_attribute)
+ #if __has_attribute(target_clones)
+ #define HAVERSINE_SIMD 1
+ #endif
+ #endif
+
+ // -DHAVERSINE_PIN_AVX2 or -DHAVERSINE_PIN_SSE2 builds only that clone, so
+ // haversine_check can test each one on any machine
+ #if defined(HAVERSINE_PIN_AVX2)
+ #define HAVERSINE_TARGETS __attribute__((target("avx2")))
+ #elif defined(HAVERSINE_PIN_SSE2)
+ #define HAVERSINE_TARGETS
+ #else
+ #define HAVERSINE_TARGETS __attribute__((target_clones("avx2", "default")))
+ #endif
+ 
+ #ifdef HAVERSINE_SIMD
+ // Lane helpers return vectors by value but are always inlined, so no ABI applies
+ #pragma GCC diagnostic ignored "-Wpsabi"
+ 
+ typedef double v4d __attribute__((vector_size(32)));
+ typedef long long v4i __attribute__((vector_size(32)));
+ 
+ #define HAVERSINE_LANES 4
+ #define LANE_INLINE static inline __attribute__((always_inline))   // Inherits the caller's clone target
+ #define HAVERSINE_MAX_DEGREES 1.0e6   // Keeps k * PIO2_1 exact in the reduction; larger inputs go scalar
+ 
+ // Reduction by pi/2: PIO2_1 holds the first 33 bits, PIO2_1T the rest
+ static const double TWO_OVER_PI = 6.36619772367581382433e-01;
+ static const double PIO2_1 = 1.57079632673412561417e+00;
+ static const double PIO2_1T = 6.07710050650619224932e-11;
+ static const double ROUND_SHIFTER = 6755399441055744.0;   // 1.5 * 2^52: adding it rounds to an integer in the low bits
+ 
+ // __kernel_sin / __kernel_cos on [-pi/4, pi/4]
+ static const double S1 = -1.66666666666666324348e-01, S2 = 8.33333333332248946124e-03,
+                     S3 = -1.98412698298579493134e-04, S4 = 2.75573137070700676789e-06,
+                     S5 = -2.50507602534068634195e-08, S6 = 1.58969099521155010221e-10;
+ static const double C1 = 4.16666666666666019037e-02, C2 = -1.38888888888741095749e-03,
+                     C3 = 2.48015872894767294178e-05, C4 = -2.75573143513906633035e-07,
+                     C5 = 2.08757232129817482790e-09, C6 = -1.13596475577881948265e-11;
+ 
+ // asin(x) = x + x * R(x^2) on [0, 0.5]
+ static const double PS0 = 1.66666666666666657415e-01, PS1 = -3.25565818622400915405e-01,
+                     PS2 = 2.01212532134862925881e-01, PS3 = -4.00555345006794114027e-02,
+                     PS4 = 7.91534994289814532176e-04, PS5 = 3.47933107596021167570e-05;
+ static const double QS1 = -2.40339491173441421878e+00, QS2 = 2.02094576023350569471e+00,
+                     QS3 = -6.88283971605453293030e-01, QS4 = 7.70381505559019352791e-02;
+ static const double PIO2_HI = 1.57079632679489655800e+00, PIO2_LO = 6.12323399573676603587e-17;
+ 
+ // Vector arguments go by pointer; by value GCC notes an ABI change in the
+ // baseline clone that the pragma above cannot silence.
+ LANE_INLINE v4d select_lanes(const v4i* mask, const v4d* if_set, const v4d* if_clear) {
+     return (v4d)((*mask & (v4i)*if_set) | (~*mask & (v4i)*if_clear));
+ }
+ 
+ LANE_INLINE v4d sqrt_lanes(const v4d* x) {
+     v4d root = *x;
+     for (int i = 0; i < HAVERSINE_LANES; i++) root[i] = sqrt(root[i]);
+     return root;
+ }
+ 
+ // x = k * pi/2 + r with |r| <= pi/4; returns sin(r) and cos(r) from the fdlibm
+ // kernels, a lane mask set where k is odd and the sign bit cos(x) takes
+ LANE_INLINE void reduce_pio2(const v4d* x, v4d* sin_r, v4d* cos_r, v4i* odd, v4i* cos_sign) {
+     v4d shifted = *x * TWO_OVER_PI + ROUND_SHIFTER;
+     v4d k = shifted - ROUND_SHIFTER;
+     v4i k_bits = (v4i)shifted;
+     *odd = -(k_bits & 1);
+     *cos_sign = ((k_bits + 1) & 2) << 62;
+ 
+     v4d r = (*x - k * PIO2_1) - k * PIO2_1T;
+     v4d z = r * r;
+     v4d sin_poly = S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)));
+     *sin_r = r + z * r * (S1 + z * sin_poly);
+     v4d cos_poly = z * (C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6)))));
+     v4d half = 0.5 * z;
+     v4d w = 1.0 - half;
+     *cos_r = w + (((1.0 - w) - half) + z * cos_poly);
+ }
+ 
+ LANE_INLINE v4d sin_squared(const v4d* x) {
+     v4d s, c;
+     v4i odd, cos_sign;
+     reduce_pio2(x, &s, &c, &odd, &cos_sign);
+     v4d s2 = s * s;
+     v4d c2 = c * c;
+     return select_lanes(&odd, &c2, &s2);   // sin^2 for even k, cos^2 for odd
+ }
+ 
+ LANE_INLINE v4d cosine(const v4d* x) {
+     v4d s, c;
+     v4i odd, cos_sign;
+     reduce_pio2(x, &s, &c, &odd, &cos_sign);
+     // Selected bitwise: blending as c + odd * (s - c) loses a small s next to c ~ 1
+     return (v4d)((v4i)select_lanes(&odd, &s, &c) ^ cos_sign);
+ }
+ 
+ // asin(sqrt(a)) for 0 <= a <= 1; above 0.5 via asin(x) = pi/2 - 2 asin(sqrt((1 - x) / 2))
+ LANE_INLINE v4d asin_sqrt(const v4d* a) {
+     v4d x = sqrt_lanes(a);
+     v4i small = x < 0.5;
+     v4d reflected = (1.0 - x) * 0.5;
+     v4d t = select_lanes(&small, a, &reflected);
+     v4d t_root = sqrt_lanes(&t);
+     v4d s = select_lanes(&small, &x, &t_root);
+     v4d p = t * (PS0 + t * (PS1 + t * (PS2 + t * (PS3 + t * (PS4 + t * PS5)))));
+     v4d q = 1.0 + t * (QS1 + t * (QS2 + t * (QS3 + t * QS4)));
+     v4d v = s + s * (p / q);
+     v4d large = PIO2_HI - (2.0 * v - PIO2_LO);
+     return select_lanes(&small, &v, &large);
+ }
+ 
+ HAVERSINE_TARGETS
+ static void haversine_batch_simd(const double* lat1, const double* lon1, const double* lat2, const double* lon2,
+                                  double* distances, size_t count) {
+     const double to_radians = PI / 180.0;
+     size_t i = 0;
+     for (; i + HAVERSINE_LANES <= count; i += HAVERSINE_LANES) {
+         v4d la1, lo1, la2, lo2;
+         memcpy(&la1, lat1 + i, sizeof(v4d));
+         memcpy(&lo1, lon1 + i, sizeof(v4d));
+         memcpy(&la2, lat2 + i, sizeof(v4d));
+         memcpy(&lo2, lon2 + i, sizeof(v4d));
+         v4i out_of_range = (la1 > HAVERSINE_MAX_DEGREES) | (la1 < -HAVERSINE_MAX_DEGREES)
+                            | (lo1 > HAVERSINE_MAX_DEGREES) | (lo1 < -HAVERSINE_MAX_DEGREES)
+                            | (la2 > HAVERSINE_MAX_DEGREES) | (la2 < -HAVERSINE_MAX_DEGREES)
+                            | (lo2 > HAVERSINE_MAX_DEGREES) | (lo2 < -HAVERSINE_MAX_DEGREES);
+ 
+         v4d rad_lat1 = la1 * to_radians;
+         v4d rad_lat2 = la2 * to_radians;
+         v4d d_lat = rad_lat2 - rad_lat1;
+         v4d d_lon = lo2 * to_radians - lo1 * to_radians;
+         v4d half_lat = d_lat * 0.5;
+         v4d half_lon = d_lon * 0.5;
+         v4d a = sin_squared(&half_lat) + cosine(&rad_lat1) * cosine(&rad_lat2) * sin_squared(&half_lon);
+ 
+         // Rounding can push a just outside [0, 1]
+         v4d zero = a - a;
+         v4d one = zero + 1.0;
+         v4i below = a < 0.0;
+         v4i above = a > 1.0;
+         a = select_lanes(&below, &zero, &a);
+         a = select_lanes(&above, &one, &a);
+         v4d d = (2.0 * EARTH_RADIUS_KM) * asin_sqrt(&a);
+         memcpy(distances + i, &d, sizeof(v4d));
+ 
+         for (int lane = 0; lane < HAVERSINE_LANES; lane++) {
+             if (out_of_range[lane]) {
+                 distances[i + lane] = haversine_distance(lat1[i + lane], lon1[i + lane], lat2[i + lane], lon2[i + lane]);
+             }
+         }
+     }
+     haversine_batch_scalar(lat1 + i, lon1 + i, lat2 + i, lon2 + i, distances + i, count - i);
+ }
+ #endif
+ 
+ void haversine_batch(const double* lat1, const double* lon1, const double* lat2, const double* lon2,
+                      double* distances, size_t count) {
+ #ifdef HAVERSINE_SIMD
+     haversine_batch_simd(lat1, lon1, lat2, lon2, distances, count);
+ #else
+     haversine_batch_scalar(lat1, lon1, lat2, lon2, distances, count);
+ #endif
+ }
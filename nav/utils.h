@@ -5,9 +5,22 @@
  #ifndef UTILS_H
  #define UTILS_H
  
+ #include <stddef.h>
+ 
  #define PI 3.14159265358979323846
  #define EARTH_RADIUS_KM 6371.0
  
  double haversine_distance(double lat1, double lon1, double lat2, double lon2);
  
+ // Point on the unit sphere for a latitude/longitude in degrees. The straight
+ // chord between two such points, times EARTH_RADIUS_KM, never exceeds their
+ // haversine distance, so it is a cheap admissible A* estimate.
+ void unit_vector(double lat, double lon, double xyz[3]);
+ 
+ // haversine_distance() for count pairs of points held in separate arrays.
+ // Vectorised where the CPU allows it; results agree with the scalar
+ // function to within a few units in the last place.
+ void haversine_batch(const double* lat1, const double* lon1, const double* lat2, const double* lon2,
+                      double* distances, size_t count);
+ 
  #endif // UTILS_H
\ No newline at end of file
@@ -1,22 +1,121 @@
-#ifndef ALGORITHMS_H
-#define ALGORITHMS_H
-
-#include "graph.h"
-#include <stdbool.h>
-
-typedef struct {
-    int* path;
-    int path_length;
-    double total_distance;
-    bool found;
-} PathResult;
-
-// Core Pathfinding 
-PathResult dijkstra_shortest_path(const Graph* graph, int start_id, int end_id);
-PathResult a_star_shortest_path(const Graph* graph, int start_id, int end_id); 
-
-// Result Handling
-void free_path_result(PathResult* result);
-void print_path_result(const PathResult* result, const Graph* graph);
-
-#endif // ALGORITHMS_H
\ No newline at end of file
+ #ifndef ALGORITHMS_H
+ #define ALGORITHMS_H
+ 
+ #include "graph.h"
+ #include "pqueue.h"
+ #include <stdbool.h>
+ #include <float.h>
+ 
+ typedef struct {
+     int* path;
+     int path_length;
+     double total_distance;
+     bool found;
+     bool owns_path;   // false when path points into a caller-provided buffer
+ } PathResult;
+ 
+ typedef enum {
+     ALGO_DIJKSTRA,
+     ALGO_A_STAR,
+     ALGO_BIDIRECTIONAL_DIJKSTRA,
+     ALGO_BIDIRECTIONAL_A_STAR
+ } SearchAlgorithm;
+ 
+ // Labels of one search direction. For the backward side, predecessor holds
+ // the next node towards the target.
+ typedef struct {
+     int capacity;
+     unsigned int* visited_stamp;
+     unsigned int* settled_stamp;
+     double* distance;
+     int* predecessor;
+     IndexedHeap heap;
+ } SearchSide;
+ 
+ // Reusable per-thread search state. A node's entries are only meaningful while
+ // its stamp equals the current generation, so starting a query is O(1).
+ // The backward side is only allocated once a bidirectional query runs.
+ typedef struct {
+     int capacity;
+     unsigned int generation;
+     SearchSide forward;
+     SearchSide backward;
+ 
+     int nodes_settled;       // Statistics for the last query
+ 
+     int* path_buffer;        // Optional caller-owned output buffer for paths
+     int path_buffer_capacity;
+ } SearchWorkspace;
+ 
+ // Lower bound on the distance from node_id to end_id. Must be admissible;
+ // a consistent bound also keeps settled nodes final.
+ typedef double (*HeuristicFn)(const void* context, int node_id, int end_id);
+ 
+ // Workspace Management
+ SearchWorkspace* search_workspace_create(int capacity);
+ void search_workspace_destroy(SearchWorkspace* workspace);
+ bool search_workspace_reserve(SearchWorkspace* workspace, int capacity);
+ void search_workspace_set_path_buffer(SearchWorkspace* workspace, int* buffer, int capacity);
+ 
+ // Core Pathfinding 
+ PathResult dijkstra_shortest_path(const Graph* graph, int start_id, int end_id);
+ PathResult a_star_shortest_path(const Graph* graph, int start_id, int end_id); 
+ PathResult bidirectional_dijkstra_shortest_path(const Graph* graph, int start_id, int end_id);
+ PathResult bidirectional_a_star_shortest_path(const Graph* graph, int start_id, int end_id);
+ PathResult find_shortest_path(const Graph* graph, SearchAlgorithm algorithm, int start_id, int end_id);
+ 
+ // Pathfinding with a caller-owned workspace (no per-query allocation when a path buffer is set)
+ PathResult dijkstra_shortest_path_ws(const Graph* graph, SearchWorkspace* workspace, int start_id, int end_id);
+ PathResult a_star_shortest_path_ws(const Graph* graph, SearchWorkspace* workspace, int start_id, int end_id);
+ PathResult bidirectional_dijkstra_shortest_path_ws(const Graph* graph, SearchWorkspace* workspace, int start_id, int end_id);
+ PathResult bidirectional_a_star_shortest_path_ws(const Graph* graph, SearchWorkspace* workspace, int start_id, int end_id);
+ PathResult find_shortest_path_ws(const Graph* graph, SearchWorkspace* workspace, SearchAlgorithm algorithm, int start_id, int end_id);
+ 
+ // Settles every node reachable from source_id (walking in-edges when reverse is set).
+ // Labels stay in workspace->forward; order, if given, receives the settle order.
+ // Returns the number of settled nodes.
+ int dijkstra_settle_all_ws(const Graph* graph, SearchWorkspace* workspace, int source_id, bool reverse, int* order);
+ 
+ // Updates a full shortest path tree from source_id (distances/predecessors per
+ // node, DBL_MAX/-1 where unreachable) after the given weight changes, as
+ // returned by graph_changes_since(). Only the subtrees behind slower or closed
+ // tree edges and the nodes that cheaper edges improve are recomputed.
+ // Returns the number of nodes relabelled, or -1 on error.
+ int dijkstra_repair_tree_ws(const Graph* graph, SearchWorkspace* workspace, int source_id, double* distances,
+                             int* predecessors, const GraphChange* changes, int num_changes);
+ 
+ PathResult a_star_shortest_path_with(const Graph* graph, SearchWorkspace* workspace, int start_id, int end_id,
+                                      HeuristicFn estimate, const void* context);
+ 
+ const char* search_algorithm_name(SearchAlgorithm algorithm);
+ 
+ // Workspace primitives for search modules built on SearchWorkspace.
+ // search_workspace_begin() sizes the workspace and starts a new generation.
+ bool search_workspace_begin(SearchWorkspace* workspace, int num_nodes, bool bidirectional);
+ 
+ static inline void side_touch(SearchSide* side, unsigned int generation, int node_id) {
+     if (side->visited_stamp[node_id] != generation) {
+         side->visited_stamp[node_id] = generation;
+         side->distance[node_id] = DBL_MAX;
+         side->predecessor[node_id] = -1;
+     }
+ }
+ 
+ static inline bool side_reached(const SearchSide* side, unsigned int generation, int node_id) {
+     return side->visited_stamp[node_id] == generation && side->distance[node_id] != DBL_MAX;
+ }
+ 
+ static inline bool side_is_settled(const SearchSide* side, unsigned int generation, int node_id) {
+     return side->settled_stamp[node_id] == generation;
+ }
+ 
+ static inline void side_settle(SearchWorkspace* workspace, SearchSide* side, int node_id) {
+     side->settled_stamp[node_id] = workspace->generation;
+     workspace->nodes_settled++;
+ }
+ 
+ // Result Handling
+ void free_path_result(PathResult* result);
+ void print_path_result(const PathResult* result, const Graph* graph);
+ 
+ #endif // ALGORITHMS_H
\ No newline at end of file
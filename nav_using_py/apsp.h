@@ -0,0 +1,44 @@
+/*
+ * All-Pairs Shortest Paths - Precomputed distance and next-hop tables for small maps.
+ */
+
+ #ifndef APSP_H
+ #define APSP_H
+
+ #include "graph.h"
+ #include "algorithms.h"
+ #include <stdint.h>
+
+ #define APSP_MAX_NODES 8192      // n^2 tables: 8192 nodes already need ~400 MB
+ #define APSP_NO_HOP 0xFFFF
+
+ typedef struct {
+     int num_nodes;
+     uint64_t map_hash;           // FNV-1a of the map file the tables were built from
+     uint64_t graph_fingerprint;
+     const Graph* graph;          // Graph the tables were built or loaded for; must outlive them
+     uint64_t graph_version;      // Its version then; queries fail once it changes
+
+     // Row-major [source * num_nodes + target]
+     float* distance;             // FLT_MAX when the target is unreachable
+     uint16_t* next_hop;          // First node after source on the path, APSP_NO_HOP if unreachable
+ } DistanceMatrix;
+
+ // Lifecycle Management (num_threads <= 0 uses every online CPU)
+ DistanceMatrix* apsp_build(const Graph* graph, int num_threads);
+ void apsp_destroy(DistanceMatrix* matrix);
+
+ // File I/O. apsp_load() rejects tables built for another map or graph.
+ bool apsp_save(const DistanceMatrix* matrix, const char* filename);
+ DistanceMatrix* apsp_load(const Graph* graph, const char* filename, uint64_t map_hash);
+ uint64_t apsp_map_hash(const char* map_filename);
+
+ // Loads "<map_filename>.apsp" if it matches the map, otherwise builds and saves it
+ DistanceMatrix* apsp_load_or_build(const Graph* graph, const char* map_filename, int num_threads);
+
+ // Queries: O(1) distance, O(path length) route. After a live update to the
+ // graph they log an error and find nothing until the tables are rebuilt.
+ double apsp_distance(const DistanceMatrix* matrix, int start_id, int end_id);
+ PathResult apsp_shortest_path(const DistanceMatrix* matrix, const Graph* graph, int start_id, int end_id);
+
+ #endif // APSP_H
@@ -0,0 +1,66 @@
+/*
+ * Arena Allocator Implementation
+ *
+ * Allocations bump a cursor through the newest block. A request that does
+ * not fit starts a new block twice the size of the previous one (capped), so
+ * a graph of E edges costs O(log E) mallocs and destruction frees only the
+ * block list.
+ */
+
+ #include "arena.h"
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <stdalign.h>
+
+ #define ARENA_MIN_BLOCK_SIZE ((size_t)64 << 10)
+ #define ARENA_MAX_BLOCK_SIZE ((size_t)16 << 20)
+ #define ARENA_ALIGNMENT ((size_t)8)   // Enough for the doubles and pointers graphs store
+
+ struct ArenaBlock {
+     ArenaBlock* next;
+     size_t size;
+     size_t used;
+     alignas(max_align_t) unsigned char data[];
+ };
+
+ void arena_init(Arena* arena) {
+     arena->head = NULL;
+     arena->next_block_size = ARENA_MIN_BLOCK_SIZE;
+     arena->bytes_used = 0;
+ }
+
+ void arena_free(Arena* arena) {
+     ArenaBlock* block = arena->head;
+     while (block) {
+         ArenaBlock* next = block->next;
+         free(block);
+         block = next;
+     }
+     arena_init(arena);
+ }
+
+ void* arena_alloc(Arena* arena, size_t size) {
+     size_t aligned = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+     if (aligned < size) return NULL;
+
+     ArenaBlock* block = arena->head;
+     if (!block || block->size - block->used < aligned) {
+         size_t block_size = arena->next_block_size;
+         if (block_size < aligned) block_size = aligned;
+         block = malloc(sizeof(ArenaBlock) + block_size);
+         if (!block) {
+             fprintf(stderr, "[Arena Error] arena_alloc: Failed to allocate a %zu byte block\n", block_size);
+             return NULL;
+         }
+         block->size = block_size;
+         block->used = 0;
+         block->next = arena->head;
+         arena->head = block;
+         if (arena->next_block_size < ARENA_MAX_BLOCK_SIZE) arena->next_block_size *= 2;
+     }
+
+     void* memory = block->data + block->used;
+     block->used += aligned;
+     arena->bytes_used += aligned;
+     return memory;
+ }
@@ -0,0 +1,26 @@
+/*
+ * Arena Allocator - Bump allocation in chunks, released all at once.
+ */
+
+ #ifndef ARENA_H
+ #define ARENA_H
+
+ #include <stdbool.h>
+ #include <stddef.h>
+
+ typedef struct ArenaBlock ArenaBlock;
+
+ typedef struct {
+     ArenaBlock* head;         // Block currently being filled; older blocks follow
+     size_t next_block_size;   // Doubles with every new block up to ARENA_MAX_BLOCK_SIZE
+     size_t bytes_used;
+ } Arena;
+
+ // Lifecycle Management
+ void arena_init(Arena* arena);
+ void arena_free(Arena* arena);
+
+ // Allocation (8-byte aligned; NULL when out of memory)
+ void* arena_alloc(Arena* arena, size_t size);
+
+ #endif // ARENA_H
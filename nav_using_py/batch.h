@@ -0,0 +1,27 @@
+/*
+ * Batch Queries - Many shortest path queries over a work-stealing thread pool.
+ */
+
+ #ifndef BATCH_H
+ #define BATCH_H
+
+ #include "graph.h"
+ #include "algorithms.h"
+
+ #define BATCH_MAX_THREADS 64
+
+ typedef struct {
+     int start_id;
+     int end_id;
+ } RoutePair;
+
+ // Runs every pair with the chosen algorithm and writes results[i] for pairs[i].
+ // The graph is shared read-only; each worker owns its SearchWorkspace.
+ // num_threads <= 0 uses every online CPU. Returns false if nothing could run.
+ bool batch_shortest_paths(const Graph* graph, const RoutePair* pairs, int num_pairs,
+                           SearchAlgorithm algorithm, PathResult* results, int num_threads);
+
+ // Frees the paths of a whole results array
+ void batch_free_results(PathResult* results, int num_results);
+
+ #endif // BATCH_H
@@ -0,0 +1,471 @@
+/*
+ * Contraction Hierarchies Implementation
+ *
+ * Nodes are contracted in order of edge difference plus the number of
+ * already-contracted neighbours (lazily re-evaluated). Contracting v adds a
+ * shortcut u -> w for every in/out neighbour pair whose path through v has no
+ * witness of equal or shorter length in the remaining graph. A query runs an
+ * upward Dijkstra from each end and unpacks the shortcuts of the best meeting.
+ */
+
+ #include "ch.h"
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <float.h>
+
+ #define INFINITY_VAL DBL_MAX
+ #define CH_WITNESS_SETTLE_LIMIT 500
+
+ typedef struct {
+     ChArc* arcs;
+     int count;
+     int capacity;
+ } ArcList;
+
+ typedef struct {
+     int num_nodes;
+     ArcList* out;
+     ArcList* in;
+     bool* contracted;
+     int* contracted_neighbors;
+     SearchWorkspace* witness;
+ } ChBuilder;
+
+ // Adds node_id to the list, or lowers the existing arc's weight
+ static bool arc_list_set(ArcList* list, int node_id, int middle_id, double weight) {
+     for (int i = 0; i < list->count; i++) {
+         if (list->arcs[i].node_id == node_id) {
+             if (weight < list->arcs[i].weight) {
+                 list->arcs[i].weight = weight;
+                 list->arcs[i].middle_id = middle_id;
+             }
+             return true;
+         }
+     }
+     if (list->count == list->capacity) {
+         int capacity = list->capacity ? list->capacity * 2 : 4;
+         ChArc* arcs = realloc(list->arcs, capacity * sizeof(ChArc));
+         if (!arcs) {
+             fprintf(stderr, "[CH Error] arc_list_set: Failed to grow arc list\n");
+             return false;
+         }
+         list->arcs = arcs;
+         list->capacity = capacity;
+     }
+     list->arcs[list->count++] = (ChArc){ .node_id = node_id, .middle_id = middle_id, .weight = weight };
+     return true;
+ }
+
+ static void builder_free(ChBuilder* b) {
+     if (b->out) for (int i = 0; i < b->num_nodes; i++) free(b->out[i].arcs);
+     if (b->in) for (int i = 0; i < b->num_nodes; i++) free(b->in[i].arcs);
+     free(b->out);
+     free(b->in);
+     free(b->contracted);
+     free(b->contracted_neighbors);
+     search_workspace_destroy(b->witness);
+ }
+
+ static bool builder_init(ChBuilder* b, const Graph* graph) {
+     int n = get_node_count(graph);
+     memset(b, 0, sizeof(*b));
+     b->num_nodes = n;
+     b->out = calloc(n, sizeof(ArcList));
+     b->in = calloc(n, sizeof(ArcList));
+     b->contracted = calloc(n, sizeof(bool));
+     b->contracted_neighbors = calloc(n, sizeof(int));
+     b->witness = search_workspace_create(n);
+     if (!b->out || !b->in || !b->contracted || !b->contracted_neighbors || !b->witness) {
+         fprintf(stderr, "[CH Error] ch_build: Failed to allocate builder for %d nodes\n", n);
+         return false;
+     }
+     for (int u = 0; u < n; u++) {
+         const int* targets;
+         const double* weights;
+         int degree = get_out_edges(graph, u, &targets, &weights);
+         for (int i = 0; i < degree; i++) {
+             if (targets[i] == u) continue;
+             if (!arc_list_set(&b->out[u], targets[i], -1, weights[i])) return false;
+             if (!arc_list_set(&b->in[targets[i]], u, -1, weights[i])) return false;
+         }
+     }
+     return true;
+ }
+
+ // Bounded Dijkstra from source over uncontracted nodes, never entering excluded_id
+ static void witness_search(ChBuilder* b, int source_id, int excluded_id, double max_distance) {
+     SearchWorkspace* ws = b->witness;
+     search_workspace_begin(ws, b->num_nodes, false);
+     SearchSide* side = &ws->forward;
+     unsigned int gen = ws->generation;
+
+     side_touch(side, gen, source_id);
+     side->distance[source_id] = 0.0;
+     heap_push_or_decrease(&side->heap, source_id, 0.0);
+
+     while (!heap_is_empty(&side->heap) && ws->nodes_settled < CH_WITNESS_SETTLE_LIMIT) {
+         double key;
+         int current_id = heap_pop_min(&side->heap, &key);
+         if (key > max_distance) break;
+         side_settle(ws, side, current_id);
+
+         const ArcList* arcs = &b->out[current_id];
+         for (int i = 0; i < arcs->count; i++) {
+             int neighbor_id = arcs->arcs[i].node_id;
+             if (neighbor_id == excluded_id || b->contracted[neighbor_id]) continue;
+             if (side_is_settled(side, gen, neighbor_id)) continue;
+             side_touch(side, gen, neighbor_id);
+             double new_dist = key + arcs->arcs[i].weight;
+             if (new_dist < side->distance[neighbor_id]) {
+                 side->distance[neighbor_id] = new_dist;
+                 heap_push_or_decrease(&side->heap, neighbor_id, new_dist);
+             }
+         }
+     }
+ }
+
+ // Counts (and with apply, inserts) the shortcuts needed to contract node_id.
+ // Returns -1 on allocation failure.
+ static int contract_node(ChBuilder* b, int node_id, bool apply) {
+     const ArcList* in = &b->in[node_id];
+     const ArcList* out = &b->out[node_id];
+     int shortcuts = 0;
+
+     for (int i = 0; i < in->count; i++) {
+         int from_id = in->arcs[i].node_id;
+         if (b->contracted[from_id]) continue;
+
+         // -1 until an uncontracted out-arc is seen; candidates may weigh 0
+         double max_candidate = -1.0;
+         for (int j = 0; j < out->count; j++) {
+             int to_id = out->arcs[j].node_id;
+             if (to_id == from_id || b->contracted[to_id]) continue;
+             double candidate = in->arcs[i].weight + out->arcs[j].weight;
+             if (candidate > max_candidate) max_candidate = candidate;
+         }
+         if (max_candidate < 0.0) continue;
+
+         witness_search(b, from_id, node_id, max_candidate);
+         const SearchSide* side = &b->witness->forward;
+         unsigned int gen = b->witness->generation;
+
+         for (int j = 0; j < out->count; j++) {
+             int to_id = out->arcs[j].node_id;
+             if (to_id == from_id || b->contracted[to_id]) continue;
+             double candidate = in->arcs[i].weight + out->arcs[j].weight;
+             if (side_reached(side, gen, to_id) && side->distance[to_id] <= candidate) continue;
+
+             shortcuts++;
+             if (apply) {
+                 if (!arc_list_set(&b->out[from_id], to_id, node_id, candidate)) return -1;
+                 if (!arc_list_set(&b->in[to_id], from_id, node_id, candidate)) return -1;
+             }
+         }
+     }
+     return shortcuts;
+ }
+
+ static double node_priority(ChBuilder* b, int node_id) {
+     int removed = 0;
+     for (int i = 0; i < b->in[node_id].count; i++) {
+         if (!b->contracted[b->in[node_id].arcs[i].node_id]) removed++;
+     }
+     for (int i = 0; i < b->out[node_id].count; i++) {
+         if (!b->contracted[b->out[node_id].arcs[i].node_id]) removed++;
+     }
+     int shortcuts = contract_node(b, node_id, false);
+     return (double)(shortcuts - removed) + b->contracted_neighbors[node_id];
+ }
+
+ static bool compute_order(ChBuilder* b, ContractionHierarchy* ch) {
+     IndexedHeap queue;
+     if (!heap_init(&queue, b->num_nodes)) return false;
+     for (int v = 0; v < b->num_nodes; v++) {
+         heap_push_or_decrease(&queue, v, node_priority(b, v));
+     }
+
+     int next_rank = 0;
+     while (!heap_is_empty(&queue)) {
+         int node_id = heap_pop_min(&queue, NULL);
+
+         // Lazy update: re-queue if the stale priority no longer holds
+         double priority = node_priority(b, node_id);
+         if (!heap_is_empty(&queue) && priority > heap_min_key(&queue)) {
+             heap_push_or_decrease(&queue, node_id, priority);
+             continue;
+         }
+
+         int added = contract_node(b, node_id, true);
+         if (added < 0) {
+             heap_free(&queue);
+             return false;
+         }
+         ch->num_shortcuts += added;
+         b->contracted[node_id] = true;
+         ch->rank[node_id] = next_rank++;
+
+         const ArcList* lists[2] = { &b->in[node_id], &b->out[node_id] };
+         for (int l = 0; l < 2; l++) {
+             for (int i = 0; i < lists[l]->count; i++) {
+                 int neighbor_id = lists[l]->arcs[i].node_id;
+                 if (b->contracted[neighbor_id]) continue;
+                 b->contracted_neighbors[neighbor_id]++;
+                 heap_update(&queue, neighbor_id, node_priority(b, neighbor_id));
+             }
+         }
+     }
+     heap_free(&queue);
+     return true;
+ }
+
+ // Splits every arc into the upward graph of its lower-ranked endpoint
+ static bool assemble_search_graphs(const ChBuilder* b, ContractionHierarchy* ch) {
+     int n = b->num_nodes;
+     ch->up_offsets = calloc(n + 1, sizeof(int));
+     ch->down_offsets = calloc(n + 1, sizeof(int));
+     if (!ch->up_offsets || !ch->down_offsets) return false;
+
+     for (int u = 0; u < n; u++) {
+         for (int i = 0; i < b->out[u].count; i++) {
+             int v = b->out[u].arcs[i].node_id;
+             if (ch->rank[u] < ch->rank[v]) ch->up_offsets[u + 1]++;
+             else ch->down_offsets[v + 1]++;
+         }
+     }
+     for (int i = 0; i < n; i++) {
+         ch->up_offsets[i + 1] += ch->up_offsets[i];
+         ch->down_offsets[i + 1] += ch->down_offsets[i];
+     }
+
+     ch->up_arcs = malloc((ch->up_offsets[n] > 0 ? ch->up_offsets[n] : 1) * sizeof(ChArc));
+     ch->down_arcs = malloc((ch->down_offsets[n] > 0 ? ch->down_offsets[n] : 1) * sizeof(ChArc));
+     int* up_fill = malloc((n > 0 ? n : 1) * sizeof(int));
+     int* down_fill = malloc((n > 0 ? n : 1) * sizeof(int));
+     if (!ch->up_arcs || !ch->down_arcs || !up_fill || !down_fill) {
+         free(up_fill);
+         free(down_fill);
+         return false;
+     }
+     memcpy(up_fill, ch->up_offsets, n * sizeof(int));
+     memcpy(down_fill, ch->down_offsets, n * sizeof(int));
+
+     for (int u = 0; u < n; u++) {
+         for (int i = 0; i < b->out[u].count; i++) {
+             ChArc arc = b->out[u].arcs[i];
+             int v = arc.node_id;
+             if (ch->rank[u] < ch->rank[v]) {
+                 ch->up_arcs[up_fill[u]++] = arc;
+             } else {
+                 arc.node_id = u;
+                 ch->down_arcs[down_fill[v]++] = arc;
+             }
+         }
+     }
+     free(up_fill);
+     free(down_fill);
+     return true;
+ }
+
+ ContractionHierarchy* ch_build(const Graph* graph) {
+     if (!is_graph_frozen(graph)) {
+         fprintf(stderr, "[CH Error] ch_build: Graph is NULL or not frozen (call graph_freeze)\n");
+         return NULL;
+     }
+
+     ContractionHierarchy* ch = calloc(1, sizeof(ContractionHierarchy));
+     if (!ch) {
+         fprintf(stderr, "[CH Error] ch_build: Failed to allocate hierarchy\n");
+         return NULL;
+     }
+     ch->num_nodes = get_node_count(graph);
+     ch->graph = graph;
+     ch->graph_version = graph_version(graph);
+     ch->rank = malloc((ch->num_nodes > 0 ? ch->num_nodes : 1) * sizeof(int));
+
+     ChBuilder builder = { 0 };
+     bool ok = ch->rank && builder_init(&builder, graph)
+               && compute_order(&builder, ch)
+               && assemble_search_graphs(&builder, ch);
+     builder_free(&builder);
+
+     if (!ok) {
+         fprintf(stderr, "[CH Error] ch_build: Preprocessing failed\n");
+         ch_destroy(ch);
+         return NULL;
+     }
+     return ch;
+ }
+
+ void ch_destroy(ContractionHierarchy* ch) {
+     if (!ch) return;
+     free(ch->rank);
+     free(ch->up_offsets);
+     free(ch->up_arcs);
+     free(ch->down_offsets);
+     free(ch->down_arcs);
+     free(ch);
+ }
+
+ // Finds the hierarchy arc from_id -> to_id (it lives with the lower-ranked end)
+ static const ChArc* find_arc(const ContractionHierarchy* ch, int from_id, int to_id) {
+     if (ch->rank[from_id] < ch->rank[to_id]) {
+         for (int i = ch->up_offsets[from_id]; i < ch->up_offsets[from_id + 1]; i++) {
+             if (ch->up_arcs[i].node_id == to_id) return &ch->up_arcs[i];
+         }
+     } else {
+         for (int i = ch->down_offsets[to_id]; i < ch->down_offsets[to_id + 1]; i++) {
+             if (ch->down_arcs[i].node_id == from_id) return &ch->down_arcs[i];
+         }
+     }
+     return NULL;
+ }
+
+ typedef struct {
+     int* nodes;
+     int length;
+     int capacity;
+ } NodeBuffer;
+
+ static bool node_buffer_push(NodeBuffer* buffer, int node_id) {
+     if (buffer->length == buffer->capacity) {
+         int capacity = buffer->capacity ? buffer->capacity * 2 : 16;
+         int* nodes = realloc(buffer->nodes, capacity * sizeof(int));
+         if (!nodes) return false;
+         buffer->nodes = nodes;
+         buffer->capacity = capacity;
+     }
+     buffer->nodes[buffer->length++] = node_id;
+     return true;
+ }
+
+ // Appends the original nodes of arc from_id -> to_id (excluding from_id)
+ static bool unpack_arc(const ContractionHierarchy* ch, int from_id, int to_id, NodeBuffer* out, NodeBuffer* stack) {
+     stack->length = 0;
+     if (!node_buffer_push(stack, from_id) || !node_buffer_push(stack, to_id)) return false;
+     while (stack->length > 0) {
+         int b = stack->nodes[--stack->length];
+         int a = stack->nodes[--stack->length];
+         const ChArc* arc = find_arc(ch, a, b);
+         if (!arc) {
+             fprintf(stderr, "[CH Error] unpack_arc: Missing arc %d -> %d\n", a, b);
+             return false;
+         }
+         if (arc->middle_id == -1) {
+             if (!node_buffer_push(out, b)) return false;
+             continue;
+         }
+         // Push the second half first so the first half is unpacked first
+         int m = arc->middle_id;
+         if (!node_buffer_push(stack, m) || !node_buffer_push(stack, b)) return false;
+         if (!node_buffer_push(stack, a) || !node_buffer_push(stack, m)) return false;
+     }
+     return true;
+ }
+
+ static bool unpack_path(const ContractionHierarchy* ch, const SearchWorkspace* ws, int start_id, int meeting_id, PathResult* result) {
+     NodeBuffer hierarchy = { 0 }, out = { 0 }, stack = { 0 };
+     bool ok = true;
+
+     // Hierarchy path: start .. meeting via forward labels, then meeting .. end via backward labels
+     for (int at = meeting_id; at != -1 && ok; at = ws->forward.predecessor[at]) ok = node_buffer_push(&hierarchy, at);
+     for (int i = 0, j = hierarchy.length - 1; i < j; i++, j--) {
+         int tmp = hierarchy.nodes[i];
+         hierarchy.nodes[i] = hierarchy.nodes[j];
+         hierarchy.nodes[j] = tmp;
+     }
+     for (int at = ws->backward.predecessor[meeting_id]; at != -1 && ok; at = ws->backward.predecessor[at]) {
+         ok = node_buffer_push(&hierarchy, at);
+     }
+
+     ok = ok && node_buffer_push(&out, start_id);
+     for (int i = 0; ok && i + 1 < hierarchy.length; i++) {
+         ok = unpack_arc(ch, hierarchy.nodes[i], hierarchy.nodes[i + 1], &out, &stack);
+     }
+
+     free(hierarchy.nodes);
+     free(stack.nodes);
+     if (!ok) {
+         free(out.nodes);
+         return false;
+     }
+     result->path = out.nodes;
+     result->path_length = out.length;
+     result->owns_path = true;
+     return true;
+ }
+
+ PathResult ch_shortest_path_ws(const ContractionHierarchy* ch, SearchWorkspace* ws, int start_id, int end_id) {
+     PathResult result = { .found = false };
+     if (!ch || !ws) {
+         fprintf(stderr, "[CH Error] ch_shortest_path: Hierarchy or workspace is NULL\n");
+         return result;
+     }
+     if (graph_version(ch->graph) != ch->graph_version) {
+         fprintf(stderr, "[CH Error] ch_shortest_path: Graph changed since build, rebuild the hierarchy\n");
+         return result;
+     }
+     if (start_id < 0 || start_id >= ch->num_nodes || end_id < 0 || end_id >= ch->num_nodes) return result;
+     if (!search_workspace_begin(ws, ch->num_nodes, true)) return result;
+
+     SearchSide* fwd = &ws->forward;
+     SearchSide* bwd = &ws->backward;
+     unsigned int gen = ws->generation;
+
+     side_touch(fwd, gen, start_id);
+     fwd->distance[start_id] = 0.0;
+     heap_push_or_decrease(&fwd->heap, start_id, 0.0);
+     side_touch(bwd, gen, end_id);
+     bwd->distance[end_id] = 0.0;
+     heap_push_or_decrease(&bwd->heap, end_id, 0.0);
+
+     double best = INFINITY_VAL;
+     int meeting_id = -1;
+
+     for (;;) {
+         bool forward_active = !heap_is_empty(&fwd->heap) && heap_min_key(&fwd->heap) < best;
+         bool backward_active = !heap_is_empty(&bwd->heap) && heap_min_key(&bwd->heap) < best;
+         if (!forward_active && !backward_active) break;
+
+         bool forward_step = forward_active &&
+                             (!backward_active || heap_min_key(&fwd->heap) <= heap_min_key(&bwd->heap));
+         SearchSide* side = forward_step ? fwd : bwd;
+         SearchSide* other = forward_step ? bwd : fwd;
+         const int* offsets = forward_step ? ch->up_offsets : ch->down_offsets;
+         const ChArc* arcs = forward_step ? ch->up_arcs : ch->down_arcs;
+
+         int current_id = heap_pop_min(&side->heap, NULL);
+         side_settle(ws, side, current_id);
+         if (side_reached(other, gen, current_id) && side->distance[current_id] + other->distance[current_id] < best) {
+             best = side->distance[current_id] + other->distance[current_id];
+             meeting_id = current_id;
+         }
+
+         for (int i = offsets[current_id]; i < offsets[current_id + 1]; i++) {
+             int neighbor_id = arcs[i].node_id;
+             if (side_is_settled(side, gen, neighbor_id)) continue;
+             side_touch(side, gen, neighbor_id);
+             double new_dist = side->distance[current_id] + arcs[i].weight;
+             if (new_dist < side->distance[neighbor_id]) {
+                 side->distance[neighbor_id] = new_dist;
+                 side->predecessor[neighbor_id] = current_id;
+                 heap_push_or_decrease(&side->heap, neighbor_id, new_dist);
+             }
+         }
+     }
+
+     if (meeting_id != -1 && unpack_path(ch, ws, start_id, meeting_id, &result)) {
+         result.total_distance = best;
+         result.found = true;
+     }
+     return result;
+ }
+
+ PathResult ch_shortest_path(const ContractionHierarchy* ch, int start_id, int end_id) {
+     PathResult result = { .found = false };
+     SearchWorkspace* ws = search_workspace_create(ch ? ch->num_nodes : 0);
+     if (!ws) return result;
+     result = ch_shortest_path_ws(ch, ws, start_id, end_id);
+     search_workspace_destroy(ws);
+     return result;
+ }
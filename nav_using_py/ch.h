@@ -0,0 +1,45 @@
+/*
+ * Contraction Hierarchies - Preprocessed shortest path queries.
+ */
+
+ #ifndef CH_H
+ #define CH_H
+
+ #include "graph.h"
+ #include "algorithms.h"
+
+ // One arc of the hierarchy. middle_id is the contracted node a shortcut
+ // bypasses, or -1 for an original road.
+ typedef struct {
+     int node_id;
+     int middle_id;
+     double weight;
+ } ChArc;
+
+ typedef struct {
+     int num_nodes;
+     int num_shortcuts;
+     const Graph* graph;      // Graph the hierarchy was built from; must outlive it
+     uint64_t graph_version;  // Its version at build time; queries fail once it changes
+     int* rank;               // Contraction order: higher rank = more important
+
+     // Upward arcs u -> v with rank[v] > rank[u], grouped by u
+     int* up_offsets;
+     ChArc* up_arcs;
+
+     // Arcs u -> v with rank[u] > rank[v], grouped by v (node_id holds u);
+     // the backward search climbs these from the target
+     int* down_offsets;
+     ChArc* down_arcs;
+ } ContractionHierarchy;
+
+ // Lifecycle Management
+ ContractionHierarchy* ch_build(const Graph* graph);
+ void ch_destroy(ContractionHierarchy* ch);
+
+ // Queries (same PathResult as dijkstra_shortest_path). After a live update
+ // to the graph they log an error and find nothing until the hierarchy is rebuilt.
+ PathResult ch_shortest_path(const ContractionHierarchy* ch, int start_id, int end_id);
+ PathResult ch_shortest_path_ws(const ContractionHierarchy* ch, SearchWorkspace* workspace, int start_id, int end_id);
+
+ #endif // CH_H
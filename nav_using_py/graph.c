@@ -1,251 +1,1023 @@
-#include "graph.h"
-#include "utils.h"  
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
+ #define _POSIX_C_SOURCE 200809L
 
-Graph* create_graph(int capacity) {
-    if (capacity <= 0) {
-        fprintf(stderr, "[Graph Error] create_graph: Invalid capacity %d\n", capacity);
-        return NULL;
-    }
-    
-    Graph* graph = malloc(sizeof(Graph));
-    if (!graph) {
-        fprintf(stderr, "[Graph Error] create_graph: Failed to allocate memory for graph struct\n");
-        return NULL;
-    }
-    
-    graph->nodes = calloc(capacity, sizeof(Node));
-    graph->adjacency_list = calloc(capacity, sizeof(Edge*));
-    
-    if (!graph->nodes || !graph->adjacency_list) {
-        fprintf(stderr, "[Graph Error] create_graph: Failed to allocate memory for node/adjacency lists\n");
-        free(graph->nodes);
-        free(graph->adjacency_list);
-        free(graph);
-        return NULL;
-    }
-    
-    graph->num_nodes = 0;
-    graph->num_edges = 0;
-    graph->capacity = capacity;
-    return graph;
-}
-
-void destroy_graph(Graph* graph) {
-    if (!graph) return;
-    
-    for (int i = 0; i < graph->num_nodes; i++) {
-        Edge* current = graph->adjacency_list[i];
-        while (current) {
-            Edge* temp = current;
-            current = current->next;
-            free(temp);
-        }
-    }
-    
-    free(graph->nodes);
-    free(graph->adjacency_list);
-    free(graph);
-}
-
-int add_node(Graph* graph, double latitude, double longitude, const char* name) {
-    if (!graph) return -1;
-    if (graph->num_nodes >= graph->capacity) {
-        fprintf(stderr, "[Graph Error] add_node: Graph is full (capacity %d)\n", graph->capacity);
-        return -1;
-    }
-    
-    int node_id = graph->num_nodes;
-    graph->nodes[node_id].id = node_id;
-    graph->nodes[node_id].latitude = latitude;
-    graph->nodes[node_id].longitude = longitude;
-    
-    strncpy(graph->nodes[node_id].name, name, sizeof(graph->nodes[node_id].name) - 1);
-    graph->nodes[node_id].name[sizeof(graph->nodes[node_id].name) - 1] = '\0';
-    
-    graph->adjacency_list[node_id] = NULL;
-    graph->num_nodes++;
-    return node_id;
-}
-
-bool add_edge(Graph* graph, int source_id, int destination_id, double weight, const char* road_name) {
-    if (!graph || !is_valid_node(graph, source_id) || !is_valid_node(graph, destination_id)) {
-        fprintf(stderr, "[Graph Error] add_edge: Invalid source (%d) or destination (%d)\n", source_id, destination_id);
-        return false;
-    }
-    
-    Edge* new_edge = malloc(sizeof(Edge));
-    if (!new_edge) {
-        fprintf(stderr, "[Graph Error] add_edge: Failed to allocate memory for new edge\n");
-        return false;
-    }
-    
-    new_edge->destination_id = destination_id;
-    new_edge->weight = weight;
-    
-    if (road_name) {
-        strncpy(new_edge->road_name, road_name, sizeof(new_edge->road_name) - 1);
-        new_edge->road_name[sizeof(new_edge->road_name) - 1] = '\0';
-    } else {
-        snprintf(new_edge->road_name, sizeof(new_edge->road_name), "Path");
-    }
-    
-    // Insert at the head of the linked list
-    new_edge->next = graph->adjacency_list[source_id];
-    graph->adjacency_list[source_id] = new_edge;
-    
-    graph->num_edges++;
-    return true;
-}
-
-bool add_bidirectional_edge(Graph* graph, int node1_id, int node2_id, double weight, const char* road_name) {
-    // Assuming that the path is bidirectional i.e. two way
-    if (!add_edge(graph, node1_id, node2_id, weight, road_name)) return false;
-    if (!add_edge(graph, node2_id, node1_id, weight, road_name)) {
-        return false;
-    }
-    return true;
-}
-
-const Node* get_node(const Graph* graph, int node_id) {
-    if (!is_valid_node(graph, node_id)) return NULL;
-    return &graph->nodes[node_id];
-}
-
-const Edge* get_edges(const Graph* graph, int node_id) {
-    if (!is_valid_node(graph, node_id)) return NULL;
-    return graph->adjacency_list[node_id];
-}
-
-bool is_valid_node(const Graph* graph, int node_id) {
-    return graph && node_id >= 0 && node_id < graph->num_nodes;
-}
-
-int get_node_count(const Graph* graph) {
-    return graph ? graph->num_nodes : 0;
-}
-
-void print_graph(const Graph* graph) {
-    if (!graph) {
-        printf("Graph is NULL.\n");
-        return;
-    }
-    printf("Graph Info (Nodes: %d, Edges: %d, Capacity: %d)\n", graph->num_nodes, graph->num_edges, graph->capacity);
-    for (int i = 0; i < graph->num_nodes; i++) {
-        const Node* n = &graph->nodes[i];
-        printf("Node %d: '%s' (%.5f, %.5f)\n", n->id, n->name, n->latitude, n->longitude);
-        const Edge* edge = graph->adjacency_list[i];
-        if (edge) {
-            printf("  -> Edges: ");
-            while (edge) {
-                printf("[%d](%.2fkm) ", edge->destination_id, edge->weight);
-                edge = edge->next;
-            }
-            printf("\n");
-        }
-    }
-    printf("\n");
-}
-
-bool load_road_network(Graph* graph, const char* filename) {
-    if (!graph || !filename) {
-        fprintf(stderr, "[Graph Error] load_road_network: Graph or filename is NULL.\n");
-        return false;
-    }
-    
-    FILE* file = fopen(filename, "r");
-    if (!file) {
-        fprintf(stderr, "[Graph Error] load_road_network: Could not open file '%s'.\n", filename);
-        return false;
-    }
-
-    char line[256];
-    int file_nodes_count = 0, file_edges_count = 0;
-
-    // Read header (num_nodes num_edges)
-    while (fgets(line, sizeof(line), file)) {
-        if (line[0] == '#' || line[0] == '\n') continue; // Skip comments/blank lines
-        if (sscanf(line, "%d %d", &file_nodes_count, &file_edges_count) == 2) {
-            break;
-        }
-    }
-
-    if (file_nodes_count == 0) {
-         fprintf(stderr, "[Graph Error] load_road_network: Failed to read node/edge count header from '%s'.\n", filename);
-         fclose(file);
+ #include "graph.h"
+ #include "textmap.h"
+ #include "utils.h"
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <limits.h>
+ #include <math.h>
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+ 
+ #define MAP_FILE_MAGIC "CNAVMAP"
+ #define MAP_FILE_VERSION 1
+ #define MAP_BYTE_ORDER 0x01020304u
+ 
+ // Binary map header. Sections follow in this order, each padded to 8 bytes:
+ // latitudes, longitudes, name offsets, names blob, then the forward and
+ // reverse CSR (offsets, targets/sources, weights).
+ typedef struct {
+     char magic[8];
+     uint32_t version;
+     uint32_t header_size;
+     int32_t num_nodes;
+     int32_t num_edges;
+     uint64_t names_size;
+     uint64_t payload_size;
+     uint64_t checksum;       // FNV-1a over the payload, one 64-bit word at a time
+     uint32_t byte_order;
+     uint32_t reserved;
+ } MapFileHeader;
+ 
+ enum {
+     MAP_LATITUDES, MAP_LONGITUDES, MAP_NAME_OFFSETS, MAP_NAMES,
+     MAP_EDGE_OFFSETS, MAP_EDGE_TARGETS, MAP_EDGE_WEIGHTS,
+     MAP_REV_OFFSETS, MAP_REV_SOURCES, MAP_REV_WEIGHTS,
+     MAP_SECTION_COUNT
+ };
+ 
+ // Empty name table holding only the default road name
+ static bool init_names(Graph* graph) {
+     if (!strtab_init(&graph->names)) return false;
+     if (strtab_intern(&graph->names, "Path", 4) != GRAPH_DEFAULT_ROAD_NAME_ID) {
+         strtab_free(&graph->names);
          return false;
-    }
-
-    if (file_nodes_count > graph->capacity) {
-        fprintf(stderr, "[Graph Error] load_road_network: Map requires %d nodes, but graph capacity is only %d.\n", 
-                file_nodes_count, graph->capacity);
-        fclose(file);
-        return false;
-    }
-
-    // Read nodes
-    int nodes_read = 0;
-    while (nodes_read < file_nodes_count && fgets(line, sizeof(line), file)) {
-        if (line[0] == '#' || line[0] == '\n') continue;
-        
-        double lat, lon;
-        char name[64] = "";
-        // Use sscanf to parse the line
-        if (sscanf(line, "%lf %lf %59[^\n]", &lat, &lon, name) >= 2) {
-            if (add_node(graph, lat, lon, name) == -1) {
-                fprintf(stderr, "[Graph Error] load_road_network: Failed to add node.\n");
-                fclose(file);
-                return false;
-            }
-            nodes_read++;
-        } else {
-             fprintf(stderr, "[Graph Error] load_road_network: Malformed node line: %s", line);
-        }
-    }
-
-    if (nodes_read != file_nodes_count) {
-        fprintf(stderr, "[Graph Error] load_road_network: Expected %d nodes, but only read %d.\n", 
-                file_nodes_count, nodes_read);
-        fclose(file);
-        return false;
-    }
-
-    // Read edges
-    int edges_read = 0;
-    while (edges_read < file_edges_count && fgets(line, sizeof(line), file)) {
-        if (line[0] == '#' || line[0] == '\n') continue;
-        
-        int source, dest;
-        double weight = 0.0; 
-        
-        int items_scanned = sscanf(line, "%d %d %lf", &source, &dest, &weight);
-        
-        if (items_scanned >= 2) {
-            if (weight <= 0) { 
-                const Node* n1 = get_node(graph, source);
-                const Node* n2 = get_node(graph, dest);
-                if (!n1 || !n2) {
-                    fprintf(stderr, "[Graph Error] load_road_network: Invalid node IDs (%d, %d) in edge line.\n", source, dest);
-                    continue;
-                }
-                weight = haversine_distance(n1->latitude, n1->longitude, n2->latitude, n2->longitude);
-            }
-            if (!add_bidirectional_edge(graph, source, dest, weight, NULL)) {
-                fprintf(stderr, "[Graph Error] load_road_network: Failed to add edge (%d, %d).\n", source, dest);
-            }
-            edges_read++;
-        } else {
-            fprintf(stderr, "[Graph Error] load_road_network: Malformed edge line: %s", line);
-        }
-    }
-
-    if (edges_read != file_edges_count) {
-        fprintf(stderr, "[Graph Error] load_road_network: Expected %d edges, but only read %d.\n", 
-                file_edges_count, edges_read);
-    }
-
-    fclose(file);
-    return true;
-}
\ No newline at end of file
+     }
+     return true;
+ }
+ 
+ Graph* create_graph(int capacity) {
+     if (capacity < 0) {
+         fprintf(stderr, "[Graph Error] create_graph: Invalid capacity %d\n", capacity);
+         return NULL;
+     }
+     if (capacity == 0) capacity = GRAPH_DEFAULT_CAPACITY;
+     
+     Graph* graph = malloc(sizeof(Graph));
+     if (!graph) {
+         fprintf(stderr, "[Graph Error] create_graph: Failed to allocate memory for graph struct\n");
+         return NULL;
+     }
+     
+     graph->nodes = calloc(capacity, sizeof(Node));
+     graph->adjacency_list = calloc(capacity, sizeof(Edge*));
+     graph->latitudes = malloc(capacity * sizeof(double));
+     graph->longitudes = malloc(capacity * sizeof(double));
+     graph->unit_vectors = malloc((size_t)capacity * 3 * sizeof(double));
+     
+     if (!graph->nodes || !graph->adjacency_list || !graph->latitudes || !graph->longitudes
+         || !graph->unit_vectors || !init_names(graph)) {
+         fprintf(stderr, "[Graph Error] create_graph: Failed to allocate memory for node/adjacency lists\n");
+         free(graph->nodes);
+         free(graph->adjacency_list);
+         free(graph->latitudes);
+         free(graph->longitudes);
+         free(graph->unit_vectors);
+         free(graph);
+         return NULL;
+     }
+     
+     graph->num_nodes = 0;
+     graph->num_edges = 0;
+     graph->capacity = capacity;
+     graph->version = 0;
+     graph->frozen = false;
+     graph->edge_offsets = NULL;
+     graph->edge_targets = NULL;
+     graph->edge_weights = NULL;
+     graph->rev_edge_offsets = NULL;
+     graph->rev_edge_sources = NULL;
+     graph->rev_edge_weights = NULL;
+     graph->mapping = NULL;
+     graph->mapping_size = 0;
+     graph->changes = NULL;
+     graph->num_changes = 0;
+     graph->changes_capacity = 0;
+     graph->changes_base = 0;
+     graph->closed_edges = NULL;
+     graph->num_closed_edges = 0;
+     graph->closed_edges_capacity = 0;
+     graph->weight_copy = NULL;
+     arena_init(&graph->arena);
+     return graph;
+ }
+ 
+ // New nodes or edges: nothing computed before can be repaired from the log
+ static void mark_structural_change(Graph* graph) {
+     graph->version++;
+     graph->num_changes = 0;
+     graph->changes_base = graph->version;
+ }
+ 
+ // Drops the packed CSR arrays; the edge lists remain the source of truth
+ static void graph_thaw(Graph* graph) {
+     if (graph->mapping) return;   // The mapping owns the arrays
+     free(graph->edge_offsets);
+     free(graph->edge_targets);
+     free(graph->edge_weights);
+     free(graph->rev_edge_offsets);
+     free(graph->rev_edge_sources);
+     free(graph->rev_edge_weights);
+     graph->edge_offsets = NULL;
+     graph->edge_targets = NULL;
+     graph->edge_weights = NULL;
+     graph->rev_edge_offsets = NULL;
+     graph->rev_edge_sources = NULL;
+     graph->rev_edge_weights = NULL;
+     graph->frozen = false;
+ }
+ 
+ void destroy_graph(Graph* graph) {
+     if (!graph) return;
+     
+     arena_free(&graph->arena);
+     strtab_free(&graph->names);
+     if (graph->mapping) {
+         munmap(graph->mapping, graph->mapping_size);
+     } else {
+         graph_thaw(graph);
+         free(graph->latitudes);
+         free(graph->longitudes);
+     }
+     free(graph->unit_vectors);
+     free(graph->nodes);
+     free(graph->adjacency_list);
+     free(graph->changes);
+     for (int i = 0; i < graph->num_closed_edges; i++) free(graph->closed_edges[i].weights);
+     free(graph->closed_edges);
+     free(graph->weight_copy);
+     free(graph);
+ }
+ 
+ // Grows the node and edge-list head arrays; the edges themselves never move
+ bool graph_reserve(Graph* graph, int capacity) {
+     if (!graph) return false;
+     if (capacity <= graph->capacity) return true;
+ 
+     Node* nodes = realloc(graph->nodes, capacity * sizeof(Node));
+     if (nodes) graph->nodes = nodes;
+     Edge** lists = realloc(graph->adjacency_list, capacity * sizeof(Edge*));
+     if (lists) graph->adjacency_list = lists;
+     double* latitudes = realloc(graph->latitudes, capacity * sizeof(double));
+     if (latitudes) graph->latitudes = latitudes;
+     double* longitudes = realloc(graph->longitudes, capacity * sizeof(double));
+     if (longitudes) graph->longitudes = longitudes;
+     double* unit_vectors = realloc(graph->unit_vectors, (size_t)capacity * 3 * sizeof(double));
+     if (unit_vectors) graph->unit_vectors = unit_vectors;
+     if (!nodes || !lists || !latitudes || !longitudes || !unit_vectors) {
+         fprintf(stderr, "[Graph Error] graph_reserve: Failed to grow graph to %d nodes\n", capacity);
+         return false;
+     }
+     memset(graph->nodes + graph->capacity, 0, (capacity - graph->capacity) * sizeof(Node));
+     memset(graph->adjacency_list + graph->capacity, 0, (capacity - graph->capacity) * sizeof(Edge*));
+     graph->capacity = capacity;
+     return true;
+ }
+ 
+ int add_node(Graph* graph, double latitude, double longitude, const char* name) {
+     if (!graph) return -1;
+     if (graph->mapping) {
+         fprintf(stderr, "[Graph Error] add_node: Graph is mapped from a binary file and read-only\n");
+         return -1;
+     }
+     if (!name) name = "";
+     int name_id = strtab_intern(&graph->names, name, strlen(name));
+     if (name_id < 0) {
+         fprintf(stderr, "[Graph Error] add_node: Failed to store node name\n");
+         return -1;
+     }
+     if (graph->num_nodes >= graph->capacity) {
+         int capacity = graph->capacity < INT_MAX / 2 ? graph->capacity * 2 : INT_MAX;
+         if (graph->num_nodes == INT_MAX || !graph_reserve(graph, capacity)) return -1;
+     }
+     
+     if (graph->frozen) graph_thaw(graph);
+ 
+     int node_id = graph->num_nodes;
+     graph->nodes[node_id].id = node_id;
+     graph->nodes[node_id].latitude = latitude;
+     graph->nodes[node_id].longitude = longitude;
+     graph->nodes[node_id].name_id = name_id;
+     graph->latitudes[node_id] = latitude;
+     graph->longitudes[node_id] = longitude;
+     unit_vector(latitude, longitude, &graph->unit_vectors[3 * node_id]);
+     graph->adjacency_list[node_id] = NULL;
+     graph->num_nodes++;
+     mark_structural_change(graph);
+     return node_id;
+ }
+ 
+ bool add_edge(Graph* graph, int source_id, int destination_id, double weight, const char* road_name) {
+     if (!graph || !is_valid_node(graph, source_id) || !is_valid_node(graph, destination_id)) {
+         fprintf(stderr, "[Graph Error] add_edge: Invalid source (%d) or destination (%d)\n", source_id, destination_id);
+         return false;
+     }
+     if (graph->mapping) {
+         fprintf(stderr, "[Graph Error] add_edge: Graph is mapped from a binary file and read-only\n");
+         return false;
+     }
+     
+     int road_name_id = GRAPH_DEFAULT_ROAD_NAME_ID;
+     if (road_name) road_name_id = strtab_intern(&graph->names, road_name, strlen(road_name));
+     if (road_name_id < 0) {
+         fprintf(stderr, "[Graph Error] add_edge: Failed to store road name\n");
+         return false;
+     }
+     
+     if (graph->frozen) graph_thaw(graph);
+ 
+     Edge* new_edge = arena_alloc(&graph->arena, sizeof(Edge));
+     if (!new_edge) {
+         fprintf(stderr, "[Graph Error] add_edge: Failed to allocate memory for new edge\n");
+         return false;
+     }
+     
+     new_edge->destination_id = destination_id;
+     new_edge->weight = weight;
+     new_edge->road_name_id = road_name_id;
+     
+     // Insert at the head of the linked list
+     new_edge->next = graph->adjacency_list[source_id];
+     graph->adjacency_list[source_id] = new_edge;
+     
+     graph->num_edges++;
+     mark_structural_change(graph);
+     return true;
+ }
+ 
+ bool add_bidirectional_edge(Graph* graph, int node1_id, int node2_id, double weight, const char* road_name) {
+     // Assuming that the path is bidirectional i.e. two way
+     if (!add_edge(graph, node1_id, node2_id, weight, road_name)) return false;
+     if (!add_edge(graph, node2_id, node1_id, weight, road_name)) {
+         return false;
+     }
+     return true;
+ }
+ 
+ // Live Updates
+ 
+ // Weight of the first source -> destination edge, false if there is none
+ static bool find_edge_weight(const Graph* graph, int source_id, int destination_id, double* weight) {
+     if (!graph->mapping) {
+         for (const Edge* edge = graph->adjacency_list[source_id]; edge; edge = edge->next) {
+             if (edge->destination_id == destination_id) {
+                 *weight = edge->weight;
+                 return true;
+             }
+         }
+         return false;
+     }
+     for (int e = graph->edge_offsets[source_id]; e < graph->edge_offsets[source_id + 1]; e++) {
+         if (graph->edge_targets[e] == destination_id) {
+             *weight = graph->edge_weights[e];
+             return true;
+         }
+     }
+     return false;
+ }
+ 
+ // A mapped file is read-only, so the first update copies its weights
+ static bool make_weights_writable(Graph* graph) {
+     if (!graph->mapping || graph->weight_copy) return true;
+     size_t m = (size_t)graph->edge_offsets[graph->num_nodes];
+     double* copy = malloc((m > 0 ? 2 * m : 1) * sizeof(double));
+     if (!copy) {
+         fprintf(stderr, "[Graph Error] graph_set_edge_weight: Failed to copy weights of the mapped graph\n");
+         return false;
+     }
+     memcpy(copy, graph->edge_weights, m * sizeof(double));
+     memcpy(copy + m, graph->rev_edge_weights, m * sizeof(double));
+     graph->weight_copy = copy;
+     graph->edge_weights = copy;
+     graph->rev_edge_weights = copy + m;
+     return true;
+ }
+ 
+ // Rewrites every source -> destination edge in the lists and, if packed, both CSR directions
+ static void write_edge_weight(Graph* graph, int source_id, int destination_id, double weight) {
+     if (!graph->mapping) {
+         for (Edge* edge = graph->adjacency_list[source_id]; edge; edge = edge->next) {
+             if (edge->destination_id == destination_id) edge->weight = weight;
+         }
+     }
+     if (!graph->frozen) return;
+     for (int e = graph->edge_offsets[source_id]; e < graph->edge_offsets[source_id + 1]; e++) {
+         if (graph->edge_targets[e] == destination_id) graph->edge_weights[e] = weight;
+     }
+     for (int e = graph->rev_edge_offsets[destination_id]; e < graph->rev_edge_offsets[destination_id + 1]; e++) {
+         if (graph->rev_edge_sources[e] == source_id) graph->rev_edge_weights[e] = weight;
+     }
+ }
+ 
+ static bool log_change(Graph* graph, int source_id, int destination_id, double old_weight, double new_weight) {
+     if (graph->num_changes == GRAPH_CHANGE_LOG_CAPACITY) {
+         // Restart the log; holders of older versions rebuild instead of repairing
+         graph->num_changes = 0;
+         graph->changes_base = graph->version;
+     }
+     if (graph->num_changes == graph->changes_capacity) {
+         int capacity = graph->changes_capacity > 0 ? graph->changes_capacity * 2 : 64;
+         GraphChange* changes = realloc(graph->changes, capacity * sizeof(GraphChange));
+         if (!changes) {
+             fprintf(stderr, "[Graph Error] graph_set_edge_weight: Failed to grow the change log\n");
+             return false;
+         }
+         graph->changes = changes;
+         graph->changes_capacity = capacity;
+     }
+     graph->version++;
+     GraphChange* change = &graph->changes[graph->num_changes++];
+     change->source_id = source_id;
+     change->destination_id = destination_id;
+     change->old_weight = old_weight;
+     change->new_weight = new_weight;
+     change->version = graph->version;
+     return true;
+ }
+ 
+ // Validates an update and returns the edge's current weight
+ static bool prepare_update(Graph* graph, int source_id, int destination_id, double* weight, const char* caller) {
+     if (!graph || !is_valid_node(graph, source_id) || !is_valid_node(graph, destination_id)) {
+         fprintf(stderr, "[Graph Error] %s: Invalid source (%d) or destination (%d)\n", caller, source_id, destination_id);
+         return false;
+     }
+     if (!find_edge_weight(graph, source_id, destination_id, weight)) {
+         fprintf(stderr, "[Graph Error] %s: No edge from %d to %d\n", caller, source_id, destination_id);
+         return false;
+     }
+     return make_weights_writable(graph);
+ }
+ 
+ // Parallel source -> destination edges, counted in the lists, or in the CSR
+ // arrays of mapped graphs, which keep list order
+ static int count_parallel_edges(const Graph* graph, int source_id, int destination_id) {
+     int found = 0;
+     if (!graph->mapping) {
+         for (const Edge* edge = graph->adjacency_list[source_id]; edge; edge = edge->next) {
+             found += edge->destination_id == destination_id;
+         }
+         return found;
+     }
+     for (int e = graph->edge_offsets[source_id]; e < graph->edge_offsets[source_id + 1]; e++) {
+         found += graph->edge_targets[e] == destination_id;
+     }
+     return found;
+ }
+ 
+ // Weights of the parallel edges in list order, for reopening them
+ static double* save_edge_weights(const Graph* graph, int source_id, int destination_id, int* count) {
+     *count = count_parallel_edges(graph, source_id, destination_id);
+     double* weights = malloc((size_t)*count * sizeof(double));
+     if (!weights) return NULL;
+     int slot = 0;
+     if (!graph->mapping) {
+         for (const Edge* edge = graph->adjacency_list[source_id]; edge; edge = edge->next) {
+             if (edge->destination_id == destination_id) weights[slot++] = edge->weight;
+         }
+     } else {
+         for (int e = graph->edge_offsets[source_id]; e < graph->edge_offsets[source_id + 1]; e++) {
+             if (graph->edge_targets[e] == destination_id) weights[slot++] = graph->edge_weights[e];
+         }
+     }
+     return weights;
+ }
+ 
+ // Writes saved weights back in the order they were saved. Edges added since
+ // went to the head of the list and keep their own weights. The k-th match in
+ // the forward CSR arrays is also the k-th in the reverse ones.
+ static void restore_edge_weights(Graph* graph, const ClosedEdge* closed) {
+     int source_id = closed->source_id;
+     int destination_id = closed->destination_id;
+     int first = closed->num_weights - count_parallel_edges(graph, source_id, destination_id);
+     if (!graph->mapping) {
+         int slot = first;
+         for (Edge* edge = graph->adjacency_list[source_id]; edge; edge = edge->next) {
+             if (edge->destination_id != destination_id) continue;
+             if (slot >= 0) edge->weight = closed->weights[slot];
+             slot++;
+         }
+     }
+     if (!graph->frozen) return;
+     int slot = first;
+     for (int e = graph->edge_offsets[source_id]; e < graph->edge_offsets[source_id + 1]; e++) {
+         if (graph->edge_targets[e] != destination_id) continue;
+         if (slot >= 0) graph->edge_weights[e] = closed->weights[slot];
+         slot++;
+     }
+     slot = first;
+     for (int e = graph->rev_edge_offsets[destination_id]; e < graph->rev_edge_offsets[destination_id + 1]; e++) {
+         if (graph->rev_edge_sources[e] != source_id) continue;
+         if (slot >= 0) graph->rev_edge_weights[e] = closed->weights[slot];
+         slot++;
+     }
+ }
+ 
+ static int find_closed_edge(const Graph* graph, int source_id, int destination_id) {
+     for (int i = 0; i < graph->num_closed_edges; i++) {
+         if (graph->closed_edges[i].source_id == source_id && graph->closed_edges[i].destination_id == destination_id) {
+             return i;
+         }
+     }
+     return -1;
+ }
+ 
+ // Changes the weight and logs the change
+ static bool update_edge_weight(Graph* graph, int source_id, int destination_id, double old_weight, double new_weight) {
+     if (old_weight == new_weight) return true;
+     if (!log_change(graph, source_id, destination_id, old_weight, new_weight)) return false;
+     write_edge_weight(graph, source_id, destination_id, new_weight);
+     return true;
+ }
+ 
+ bool graph_set_edge_weight(Graph* graph, int source_id, int destination_id, double weight) {
+     double current;
+     if (!prepare_update(graph, source_id, destination_id, &current, "graph_set_edge_weight")) return false;
+     if (!isfinite(weight) || weight < 0) {
+         fprintf(stderr, "[Graph Error] graph_set_edge_weight: Invalid weight %g\n", weight);
+         return false;
+     }
+     int closed = find_closed_edge(graph, source_id, destination_id);
+     if (closed != -1) {
+         ClosedEdge* edge = &graph->closed_edges[closed];
+         for (int i = 0; i < edge->num_weights; i++) edge->weights[i] = weight;
+         return true;
+     }
+     return update_edge_weight(graph, source_id, destination_id, current, weight);
+ }
+ 
+ bool graph_close_edge(Graph* graph, int source_id, int destination_id) {
+     double current;
+     if (!prepare_update(graph, source_id, destination_id, &current, "graph_close_edge")) return false;
+     if (find_closed_edge(graph, source_id, destination_id) != -1) return true;
+ 
+     if (graph->num_closed_edges == graph->closed_edges_capacity) {
+         int capacity = graph->closed_edges_capacity > 0 ? graph->closed_edges_capacity * 2 : 16;
+         ClosedEdge* closed = realloc(graph->closed_edges, capacity * sizeof(ClosedEdge));
+         if (!closed) {
+             fprintf(stderr, "[Graph Error] graph_close_edge: Failed to record closure\n");
+             return false;
+         }
+         graph->closed_edges = closed;
+         graph->closed_edges_capacity = capacity;
+     }
+     int num_weights;
+     double* weights = save_edge_weights(graph, source_id, destination_id, &num_weights);
+     if (!weights) {
+         fprintf(stderr, "[Graph Error] graph_close_edge: Failed to record closure\n");
+         return false;
+     }
+     if (!update_edge_weight(graph, source_id, destination_id, current, INFINITY)) {
+         free(weights);
+         return false;
+     }
+     ClosedEdge* closed = &graph->closed_edges[graph->num_closed_edges++];
+     closed->source_id = source_id;
+     closed->destination_id = destination_id;
+     closed->weights = weights;
+     closed->num_weights = num_weights;
+     return true;
+ }
+ 
+ bool graph_open_edge(Graph* graph, int source_id, int destination_id) {
+     double current;
+     if (!prepare_update(graph, source_id, destination_id, &current, "graph_open_edge")) return false;
+     int closed = find_closed_edge(graph, source_id, destination_id);
+     if (closed == -1) return true;
+ 
+     // The log records the cheapest restored weight, the one routes can use
+     ClosedEdge* edge = &graph->closed_edges[closed];
+     double cheapest = INFINITY;
+     for (int i = 0; i < edge->num_weights; i++) cheapest = fmin(cheapest, edge->weights[i]);
+     if (!log_change(graph, source_id, destination_id, current, cheapest)) return false;
+     restore_edge_weights(graph, edge);
+     free(edge->weights);
+     graph->closed_edges[closed] = graph->closed_edges[--graph->num_closed_edges];
+     return true;
+ }
+ 
+ bool graph_is_edge_closed(const Graph* graph, int source_id, int destination_id) {
+     return graph && find_closed_edge(graph, source_id, destination_id) != -1;
+ }
+ 
+ int graph_apply_updates(Graph* graph, const GraphUpdate* updates, int num_updates) {
+     if (!graph || (num_updates > 0 && !updates)) {
+         fprintf(stderr, "[Graph Error] graph_apply_updates: Graph or updates is NULL\n");
+         return 0;
+     }
+     int applied = 0;
+     for (int i = 0; i < num_updates; i++) {
+         const GraphUpdate* update = &updates[i];
+         bool ok = false;
+         switch (update->kind) {
+             case GRAPH_UPDATE_SET_WEIGHT:
+                 ok = graph_set_edge_weight(graph, update->source_id, update->destination_id, update->weight);
+                 break;
+             case GRAPH_UPDATE_CLOSE:
+                 ok = graph_close_edge(graph, update->source_id, update->destination_id);
+                 break;
+             case GRAPH_UPDATE_OPEN:
+                 ok = graph_open_edge(graph, update->source_id, update->destination_id);
+                 break;
+             default:
+                 fprintf(stderr, "[Graph Error] graph_apply_updates: Unknown update kind %d\n", (int)update->kind);
+         }
+         if (ok) applied++;
+     }
+     return applied;
+ }
+ 
+ int graph_changes_since(const Graph* graph, uint64_t version, const GraphChange** changes) {
+     if (!graph || version < graph->changes_base || version > graph->version) return -1;
+     // Versions in the log are consecutive from changes_base + 1
+     int first = (int)(version - graph->changes_base);
+     if (changes) *changes = graph->changes ? graph->changes + first : NULL;
+     return graph->num_changes - first;
+ }
+ 
+ bool graph_freeze(Graph* graph) {
+     if (!graph) return false;
+     if (graph->frozen) return true;
+ 
+     size_t edge_slots = graph->num_edges > 0 ? graph->num_edges : 1;
+     int* offsets = malloc((graph->num_nodes + 1) * sizeof(int));
+     int* targets = malloc(edge_slots * sizeof(int));
+     double* weights = malloc(edge_slots * sizeof(double));
+     int* rev_offsets = calloc(graph->num_nodes + 1, sizeof(int));
+     int* rev_sources = malloc(edge_slots * sizeof(int));
+     double* rev_weights = malloc(edge_slots * sizeof(double));
+     if (!offsets || !targets || !weights || !rev_offsets || !rev_sources || !rev_weights) {
+         fprintf(stderr, "[Graph Error] graph_freeze: Failed to allocate CSR arrays for %d edges\n", graph->num_edges);
+         free(offsets);
+         free(targets);
+         free(weights);
+         free(rev_offsets);
+         free(rev_sources);
+         free(rev_weights);
+         return false;
+     }
+ 
+     // Keep list order so ties resolve exactly as they did on the linked lists
+     int next = 0;
+     for (int i = 0; i < graph->num_nodes; i++) {
+         offsets[i] = next;
+         for (const Edge* edge = graph->adjacency_list[i]; edge; edge = edge->next) {
+             targets[next] = edge->destination_id;
+             weights[next] = edge->weight;
+             next++;
+         }
+     }
+     offsets[graph->num_nodes] = next;
+ 
+     // Reverse CSR by counting sort on the edge targets
+     for (int e = 0; e < next; e++) rev_offsets[targets[e] + 1]++;
+     for (int i = 0; i < graph->num_nodes; i++) rev_offsets[i + 1] += rev_offsets[i];
+     for (int i = 0; i < graph->num_nodes; i++) {
+         for (int e = offsets[i]; e < offsets[i + 1]; e++) {
+             int slot = rev_offsets[targets[e]]++;
+             rev_sources[slot] = i;
+             rev_weights[slot] = weights[e];
+         }
+     }
+     for (int i = graph->num_nodes; i > 0; i--) rev_offsets[i] = rev_offsets[i - 1];
+     rev_offsets[0] = 0;
+ 
+     graph->edge_offsets = offsets;
+     graph->edge_targets = targets;
+     graph->edge_weights = weights;
+     graph->rev_edge_offsets = rev_offsets;
+     graph->rev_edge_sources = rev_sources;
+     graph->rev_edge_weights = rev_weights;
+     graph->frozen = true;
+     return true;
+ }
+ 
+ bool is_graph_frozen(const Graph* graph) {
+     return graph && graph->frozen;
+ }
+ 
+ // FNV-1a hash of the frozen topology and weights, used to validate cached
+ // preprocessing files against the graph they were built from
+ uint64_t graph_fingerprint(const Graph* graph) {
+     uint64_t hash = 14695981039346656037ULL;
+     if (!is_graph_frozen(graph)) return 0;
+ 
+     const unsigned char* parts[3] = {
+         (const unsigned char*)graph->edge_offsets,
+         (const unsigned char*)graph->edge_targets,
+         (const unsigned char*)graph->edge_weights
+     };
+     size_t sizes[3] = {
+         (graph->num_nodes + 1) * sizeof(int),
+         graph->edge_offsets[graph->num_nodes] * sizeof(int),
+         graph->edge_offsets[graph->num_nodes] * sizeof(double)
+     };
+     for (int p = 0; p < 3; p++) {
+         for (size_t i = 0; i < sizes[p]; i++) {
+             hash ^= parts[p][i];
+             hash *= 1099511628211ULL;
+         }
+     }
+     return hash;
+ }
+ 
+ uint64_t graph_version(const Graph* graph) {
+     return graph ? graph->version : 0;
+ }
+ 
+ const Node* get_node(const Graph* graph, int node_id) {
+     if (!is_valid_node(graph, node_id)) return NULL;
+     return &graph->nodes[node_id];
+ }
+ 
+ const char* get_node_name(const Graph* graph, int node_id) {
+     if (!is_valid_node(graph, node_id)) return NULL;
+     return strtab_get(&graph->names, graph->nodes[node_id].name_id);
+ }
+ 
+ const char* graph_name(const Graph* graph, int name_id) {
+     return graph ? strtab_get(&graph->names, name_id) : NULL;
+ }
+ 
+ const double* get_latitudes(const Graph* graph) {
+     return graph ? graph->latitudes : NULL;
+ }
+ 
+ const double* get_longitudes(const Graph* graph) {
+     return graph ? graph->longitudes : NULL;
+ }
+ 
+ // Bounding box of all nodes; false for an empty graph
+ bool graph_bounds(const Graph* graph, double* min_lat, double* max_lat, double* min_lon, double* max_lon) {
+     if (!graph || graph->num_nodes == 0) return false;
+     const double* lat = graph->latitudes;
+     const double* lon = graph->longitudes;
+     double lat_lo = lat[0], lat_hi = lat[0], lon_lo = lon[0], lon_hi = lon[0];
+     for (int i = 1; i < graph->num_nodes; i++) {
+         lat_lo = lat[i] < lat_lo ? lat[i] : lat_lo;
+         lat_hi = lat[i] > lat_hi ? lat[i] : lat_hi;
+     }
+     for (int i = 1; i < graph->num_nodes; i++) {
+         lon_lo = lon[i] < lon_lo ? lon[i] : lon_lo;
+         lon_hi = lon[i] > lon_hi ? lon[i] : lon_hi;
+     }
+     if (min_lat) *min_lat = lat_lo;
+     if (max_lat) *max_lat = lat_hi;
+     if (min_lon) *min_lon = lon_lo;
+     if (max_lon) *max_lon = lon_hi;
+     return true;
+ }
+ 
+ const Edge* get_edges(const Graph* graph, int node_id) {
+     if (!is_valid_node(graph, node_id)) return NULL;
+     if (graph->mapping) {
+         fprintf(stderr, "[Graph Error] get_edges: Mapped graphs keep no edge lists (use get_out_edges)\n");
+         return NULL;
+     }
+     return graph->adjacency_list[node_id];
+ }
+ 
+ // Returns the out-degree of node_id and points targets/weights at its CSR slice
+ int get_out_edges(const Graph* graph, int node_id, const int** targets, const double** weights) {
+     if (!is_valid_node(graph, node_id) || !graph->frozen) return 0;
+     int begin = graph->edge_offsets[node_id];
+     if (targets) *targets = graph->edge_targets + begin;
+     if (weights) *weights = graph->edge_weights + begin;
+     return graph->edge_offsets[node_id + 1] - begin;
+ }
+ 
+ int get_in_edges(const Graph* graph, int node_id, const int** sources, const double** weights) {
+     if (!is_valid_node(graph, node_id) || !graph->frozen) return 0;
+     int begin = graph->rev_edge_offsets[node_id];
+     if (sources) *sources = graph->rev_edge_sources + begin;
+     if (weights) *weights = graph->rev_edge_weights + begin;
+     return graph->rev_edge_offsets[node_id + 1] - begin;
+ }
+ 
+ bool is_valid_node(const Graph* graph, int node_id) {
+     return graph && node_id >= 0 && node_id < graph->num_nodes;
+ }
+ 
+ int get_node_count(const Graph* graph) {
+     return graph ? graph->num_nodes : 0;
+ }
+ 
+ void print_graph(const Graph* graph) {
+     if (!graph) {
+         printf("Graph is NULL.\n");
+         return;
+     }
+     printf("Graph Info (Nodes: %d, Edges: %d, Capacity: %d)\n", graph->num_nodes, graph->num_edges, graph->capacity);
+     for (int i = 0; i < graph->num_nodes; i++) {
+         const Node* n = &graph->nodes[i];
+         printf("Node %d: '%s' (%.5f, %.5f)\n", n->id, graph_name(graph, n->name_id), n->latitude, n->longitude);
+         if (graph->frozen) {
+             const int* targets;
+             const double* weights;
+             int degree = get_out_edges(graph, i, &targets, &weights);
+             if (degree > 0) {
+                 printf("  -> Edges: ");
+                 for (int e = 0; e < degree; e++) printf("[%d](%.2fkm) ", targets[e], weights[e]);
+                 printf("\n");
+             }
+             continue;
+         }
+         const Edge* edge = graph->adjacency_list[i];
+         if (edge) {
+             printf("  -> Edges: ");
+             while (edge) {
+                 printf("[%d](%.2fkm) ", edge->destination_id, edge->weight);
+                 edge = edge->next;
+             }
+             printf("\n");
+         }
+     }
+     printf("\n");
+ }
+ 
+ bool load_road_network(Graph* graph, const char* filename) {
+     if (!graph || !filename) {
+         fprintf(stderr, "[Graph Error] load_road_network: Graph or filename is NULL.\n");
+         return false;
+     }
+     
+     FILE* file = fopen(filename, "rb");
+     if (!file) {
+         fprintf(stderr, "[Graph Error] load_road_network: Could not open file '%s'.\n", filename);
+         return false;
+     }
+ 
+     // Binary maps are recognised by their magic and mapped instead of parsed
+     char magic[sizeof(MAP_FILE_MAGIC)];
+     bool binary = fread(magic, 1, sizeof(magic), file) == sizeof(magic)
+                   && memcmp(magic, MAP_FILE_MAGIC, sizeof(magic)) == 0;
+     fclose(file);
+     if (binary) return load_binary_map(graph, filename);
+ 
+     if (!load_text_map(graph, filename)) return false;
+     return graph_freeze(graph);
+ }
+ 
+ // Binary Maps
+ static size_t pad8(size_t size) {
+     return (size + 7) & ~(size_t)7;
+ }
+ 
+ // Byte offset of every section from the start of the payload; returns the payload size
+ static size_t map_layout(size_t num_nodes, size_t num_edges, size_t names_size, size_t offsets[MAP_SECTION_COUNT]) {
+     size_t sizes[MAP_SECTION_COUNT] = {
+         [MAP_LATITUDES] = num_nodes * sizeof(double),
+         [MAP_LONGITUDES] = num_nodes * sizeof(double),
+         [MAP_NAME_OFFSETS] = (num_nodes + 1) * sizeof(uint32_t),
+         [MAP_NAMES] = names_size,
+         [MAP_EDGE_OFFSETS] = (num_nodes + 1) * sizeof(int32_t),
+         [MAP_EDGE_TARGETS] = num_edges * sizeof(int32_t),
+         [MAP_EDGE_WEIGHTS] = num_edges * sizeof(double),
+         [MAP_REV_OFFSETS] = (num_nodes + 1) * sizeof(int32_t),
+         [MAP_REV_SOURCES] = num_edges * sizeof(int32_t),
+         [MAP_REV_WEIGHTS] = num_edges * sizeof(double)
+     };
+     size_t total = 0;
+     for (int i = 0; i < MAP_SECTION_COUNT; i++) {
+         offsets[i] = total;
+         total += pad8(sizes[i]);
+     }
+     return total;
+ }
+ 
+ static uint64_t map_checksum(const unsigned char* payload, size_t size) {
+     uint64_t hash = 14695981039346656037ULL;
+     for (size_t i = 0; i + 8 <= size; i += 8) {
+         uint64_t word;
+         memcpy(&word, payload + i, sizeof(word));
+         hash ^= word;
+         hash *= 1099511628211ULL;
+     }
+     return hash;
+ }
+ 
+ bool save_binary_map(const Graph* graph, const char* filename) {
+     if (!is_graph_frozen(graph) || !filename) {
+         fprintf(stderr, "[Graph Error] save_binary_map: Graph is NULL or not frozen (call graph_freeze)\n");
+         return false;
+     }
+     size_t n = graph->num_nodes;
+     size_t m = graph->edge_offsets[n];
+     size_t names_size = 0;
+     for (size_t i = 0; i < n; i++) names_size += strlen(graph_name(graph, graph->nodes[i].name_id)) + 1;
+ 
+     size_t offsets[MAP_SECTION_COUNT];
+     size_t payload_size = map_layout(n, m, names_size, offsets);
+     unsigned char* payload = calloc(payload_size > 0 ? payload_size : 1, 1);
+     if (!payload) {
+         fprintf(stderr, "[Graph Error] save_binary_map: Failed to allocate %zu bytes\n", payload_size);
+         return false;
+     }
+ 
+     double* latitudes = (double*)(payload + offsets[MAP_LATITUDES]);
+     double* longitudes = (double*)(payload + offsets[MAP_LONGITUDES]);
+     uint32_t* name_offsets = (uint32_t*)(payload + offsets[MAP_NAME_OFFSETS]);
+     char* names = (char*)(payload + offsets[MAP_NAMES]);
+     uint32_t name_at = 0;
+     for (size_t i = 0; i < n; i++) {
+         name_offsets[i] = name_at;
+         const char* name = graph_name(graph, graph->nodes[i].name_id);
+         size_t len = strlen(name) + 1;
+         memcpy(names + name_at, name, len);
+         name_at += len;
+     }
+     name_offsets[n] = name_at;
+     memcpy(latitudes, graph->latitudes, n * sizeof(double));
+     memcpy(longitudes, graph->longitudes, n * sizeof(double));
+     memcpy(payload + offsets[MAP_EDGE_OFFSETS], graph->edge_offsets, (n + 1) * sizeof(int));
+     memcpy(payload + offsets[MAP_EDGE_TARGETS], graph->edge_targets, m * sizeof(int));
+     memcpy(payload + offsets[MAP_EDGE_WEIGHTS], graph->edge_weights, m * sizeof(double));
+     memcpy(payload + offsets[MAP_REV_OFFSETS], graph->rev_edge_offsets, (n + 1) * sizeof(int));
+     memcpy(payload + offsets[MAP_REV_SOURCES], graph->rev_edge_sources, m * sizeof(int));
+     memcpy(payload + offsets[MAP_REV_WEIGHTS], graph->rev_edge_weights, m * sizeof(double));
+ 
+     MapFileHeader header = {
+         .version = MAP_FILE_VERSION,
+         .header_size = sizeof(MapFileHeader),
+         .num_nodes = (int32_t)n,
+         .num_edges = (int32_t)m,
+         .names_size = names_size,
+         .payload_size = payload_size,
+         .checksum = map_checksum(payload, payload_size),
+         .byte_order = MAP_BYTE_ORDER
+     };
+     memcpy(header.magic, MAP_FILE_MAGIC, sizeof(header.magic));
+ 
+     FILE* file = fopen(filename, "wb");
+     if (!file) {
+         fprintf(stderr, "[Graph Error] save_binary_map: Could not open file '%s'.\n", filename);
+         free(payload);
+         return false;
+     }
+     bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+               && fwrite(payload, 1, payload_size, file) == payload_size;
+     if (fclose(file) != 0) ok = false;
+     if (!ok) fprintf(stderr, "[Graph Error] save_binary_map: Failed to write '%s'.\n", filename);
+     free(payload);
+     return ok;
+ }
+ 
+ // Returns what is wrong with a mapped header (NULL if nothing) and fills the section offsets
+ static const char* map_header_problem(const MapFileHeader* header, size_t file_size, size_t offsets[MAP_SECTION_COUNT]) {
+     if (memcmp(header->magic, MAP_FILE_MAGIC, sizeof(header->magic)) != 0) return "bad magic";
+     if (header->version != MAP_FILE_VERSION) return "unsupported version";
+     if (header->byte_order != MAP_BYTE_ORDER) return "written on a machine with another byte order";
+     if (header->header_size != sizeof(MapFileHeader) || header->num_nodes < 0 || header->num_edges < 0
+         || header->payload_size != file_size - sizeof(MapFileHeader) || header->names_size > header->payload_size
+         || header->payload_size != map_layout(header->num_nodes, header->num_edges, header->names_size, offsets)) {
+         return "section sizes do not match the header";
+     }
+     return NULL;
+ }
+ 
+ // Maps a whole binary map read-only; returns MAP_FAILED (after reporting) on error
+ static void* map_file(const char* filename, const char* caller, size_t* file_size) {
+     int fd = open(filename, O_RDONLY);
+     if (fd < 0) {
+         fprintf(stderr, "[Graph Error] %s: Could not open file '%s'.\n", caller, filename);
+         return MAP_FAILED;
+     }
+     struct stat info;
+     if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(MapFileHeader)) {
+         fprintf(stderr, "[Graph Error] %s: '%s' is too small to be a binary map.\n", caller, filename);
+         close(fd);
+         return MAP_FAILED;
+     }
+     *file_size = (size_t)info.st_size;
+     void* mapping = mmap(NULL, *file_size, PROT_READ, MAP_SHARED, fd, 0);
+     close(fd);
+     if (mapping == MAP_FAILED) fprintf(stderr, "[Graph Error] %s: Could not map '%s'.\n", caller, filename);
+     return mapping;
+ }
+ 
+ // Reads the whole payload, which is why load_binary_map() does not call it
+ bool verify_binary_map(const char* filename) {
+     if (!filename) return false;
+     size_t file_size;
+     void* mapping = map_file(filename, "verify_binary_map", &file_size);
+     if (mapping == MAP_FAILED) return false;
+     const MapFileHeader* header = mapping;
+     size_t offsets[MAP_SECTION_COUNT];
+     const char* problem = map_header_problem(header, file_size, offsets);
+     if (!problem && map_checksum((const unsigned char*)mapping + sizeof(MapFileHeader), header->payload_size)
+                     != header->checksum) {
+         problem = "checksum mismatch";
+     }
+     if (problem) {
+         fprintf(stderr, "[Graph Error] verify_binary_map: '%s' is not a valid binary map (%s).\n", filename, problem);
+     }
+     munmap(mapping, file_size);
+     return problem == NULL;
+ }
+ 
+ // Offsets must run from 0 to count without decreasing, ids must be in range
+ static bool valid_csr(const int32_t* offsets, const int32_t* ids, int32_t num_nodes, int32_t num_edges) {
+     if (offsets[0] != 0 || offsets[num_nodes] != num_edges) return false;
+     for (int32_t i = 0; i < num_nodes; i++) {
+         if (offsets[i] > offsets[i + 1]) return false;
+     }
+     for (int32_t e = 0; e < num_edges; e++) {
+         if (ids[e] < 0 || ids[e] >= num_nodes) return false;
+     }
+     return true;
+ }
+ 
+ bool load_binary_map(Graph* graph, const char* filename) {
+     if (!graph || !filename) {
+         fprintf(stderr, "[Graph Error] load_binary_map: Graph or filename is NULL.\n");
+         return false;
+     }
+     if (graph->num_nodes > 0 || graph->mapping) {
+         fprintf(stderr, "[Graph Error] load_binary_map: Graph must be empty.\n");
+         return false;
+     }
+ 
+     size_t file_size;
+     void* mapping = map_file(filename, "load_binary_map", &file_size);
+     if (mapping == MAP_FAILED) return false;
+ 
+     // Only the header and the CSR and name bounds are checked here; the
+     // checksum reads every page, so it is left to verify_binary_map()
+     const MapFileHeader* header = mapping;
+     const unsigned char* payload = (const unsigned char*)mapping + sizeof(MapFileHeader);
+     size_t offsets[MAP_SECTION_COUNT];
+     const char* problem = map_header_problem(header, file_size, offsets);
+ 
+     int32_t n = header->num_nodes;
+     int32_t m = header->num_edges;
+     const uint32_t* name_offsets = NULL;
+     const char* names = NULL;
+     if (!problem) {
+         name_offsets = (const uint32_t*)(payload + offsets[MAP_NAME_OFFSETS]);
+         names = (const char*)(payload + offsets[MAP_NAMES]);
+         if (!valid_csr((const int32_t*)(payload + offsets[MAP_EDGE_OFFSETS]),
+                        (const int32_t*)(payload + offsets[MAP_EDGE_TARGETS]), n, m)
+             || !valid_csr((const int32_t*)(payload + offsets[MAP_REV_OFFSETS]),
+                           (const int32_t*)(payload + offsets[MAP_REV_SOURCES]), n, m)) {
+             problem = "corrupt edge arrays";
+         } else if (header->names_size == 0 || name_offsets[n] != header->names_size
+                    || names[header->names_size - 1] != '\0') {
+             problem = "corrupt names blob";
+         }
+         for (int32_t i = 0; i < n && !problem; i++) {
+             if (name_offsets[i] >= header->names_size) problem = "corrupt names blob";
+         }
+     }
+     if (problem) {
+         fprintf(stderr, "[Graph Error] load_binary_map: '%s' is not a valid binary map (%s).\n", filename, problem);
+         munmap(mapping, file_size);
+         return false;
+     }
+ 
+     // The node table is rebuilt from the coordinate section; names are
+     // interned in place, so the table points into the mapping
+     if (!graph_reserve(graph, n)) {
+         munmap(mapping, file_size);
+         return false;
+     }
+     const double* latitudes = (const double*)(payload + offsets[MAP_LATITUDES]);
+     const double* longitudes = (const double*)(payload + offsets[MAP_LONGITUDES]);
+     for (int32_t i = 0; i < n; i++) {
+         Node* node = &graph->nodes[i];
+         node->id = i;
+         node->latitude = latitudes[i];
+         node->longitude = longitudes[i];
+         unit_vector(latitudes[i], longitudes[i], &graph->unit_vectors[3 * i]);
+         node->name_id = strtab_intern_static(&graph->names, names + name_offsets[i]);
+         graph->adjacency_list[i] = NULL;
+         if (node->name_id < 0) {
+             fprintf(stderr, "[Graph Error] load_binary_map: Failed to store node names\n");
+             strtab_free(&graph->names);
+             init_names(graph);
+             munmap(mapping, file_size);
+             return false;
+         }
+     }
+ 
+     // The coordinate and CSR arrays are used in place
+     free(graph->latitudes);
+     free(graph->longitudes);
+     graph->latitudes = (double*)latitudes;
+     graph->longitudes = (double*)longitudes;
+     graph->mapping = mapping;
+     graph->mapping_size = file_size;
+     graph->num_nodes = n;
+     graph->num_edges = m;
+     graph->edge_offsets = (int*)(payload + offsets[MAP_EDGE_OFFSETS]);
+     graph->edge_targets = (int*)(payload + offsets[MAP_EDGE_TARGETS]);
+     graph->edge_weights = (double*)(payload + offsets[MAP_EDGE_WEIGHTS]);
+     graph->rev_edge_offsets = (int*)(payload + offsets[MAP_REV_OFFSETS]);
+     graph->rev_edge_sources = (int*)(payload + offsets[MAP_REV_SOURCES]);
+     graph->rev_edge_weights = (double*)(payload + offsets[MAP_REV_WEIGHTS]);
+     graph->frozen = true;
+     mark_structural_change(graph);
+     return true;
+ }
@@ -0,0 +1,278 @@
+/*
+ * K Shortest Paths Implementation
+ *
+ * Yen's algorithm: each accepted path is branched at every node (the spur),
+ * keeping its prefix (the root) and searching for a new suffix that avoids
+ * the root's nodes and the edges earlier paths took out of the spur.
+ *
+ * One backward search from the target gives every node's exact distance to
+ * it. A spur search first tries the tree's own route, which is optimal
+ * whenever it avoids the root; only otherwise does it run A* with those
+ * distances as the potential, which is exact on the unrestricted graph and
+ * settles little beyond the detour. Spurs before the node where a path left
+ * its parent are skipped (Lawler), since they repeat the parent's candidates.
+ */
+
+ #include "kpaths.h"
+ #include "batch.h"
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+
+ typedef struct {
+     int* path;
+     int length;
+     int deviation;          // Index of the spur the path was found from
+     double cost;
+ } Candidate;
+
+ typedef struct {
+     const Graph* graph;
+     SearchWorkspace* ws;
+     int end_id;
+     double* to_target;      // [v] = d(v, end_id), DBL_MAX if the target is unreachable
+     int* next_hop;          // [v] = next node on the tree route to end_id
+     unsigned int* blocked;  // [v] == mark: v is on the current root
+     unsigned int mark;
+     int* banned;            // Next nodes the current spur may not use
+     int num_banned;
+     int* spur_path;         // Scratch for the spur's suffix
+ } YenState;
+
+ // Cheapest of possibly parallel edges u -> v
+ static double edge_weight(const Graph* graph, int u, int v) {
+     double weight = DBL_MAX;
+     for (int e = graph->edge_offsets[u]; e < graph->edge_offsets[u + 1]; e++) {
+         if (graph->edge_targets[e] == v && graph->edge_weights[e] < weight) weight = graph->edge_weights[e];
+     }
+     return weight;
+ }
+
+ static bool is_banned(const YenState* state, int node_id) {
+     for (int i = 0; i < state->num_banned; i++) {
+         if (state->banned[i] == node_id) return true;
+     }
+     return false;
+ }
+
+ // Shortest spur_id -> end_id suffix avoiding the root and banned first hops.
+ // Writes it to state->spur_path and returns its length, 0 if there is none.
+ static int spur_search(YenState* state, int spur_id, double* cost) {
+     const Graph* graph = state->graph;
+
+     // The tree's route is a lower bound on every suffix, so it wins if usable
+     bool tree_usable = !is_banned(state, state->next_hop[spur_id]);
+     for (int v = state->next_hop[spur_id]; tree_usable && v != -1; v = state->next_hop[v]) {
+         if (state->blocked[v] == state->mark) tree_usable = false;
+     }
+     if (tree_usable) {
+         int length = 0;
+         for (int v = spur_id; v != -1; v = state->next_hop[v]) state->spur_path[length++] = v;
+         *cost = state->to_target[spur_id];
+         return length;
+     }
+
+     SearchWorkspace* ws = state->ws;
+     if (!search_workspace_begin(ws, get_node_count(graph), false)) return 0;
+     SearchSide* fwd = &ws->forward;
+     unsigned int gen = ws->generation;
+     double* g_scores = fwd->distance;
+     IndexedHeap* pq = &fwd->heap;
+
+     side_touch(fwd, gen, spur_id);
+     g_scores[spur_id] = 0.0;
+     heap_push_or_decrease(pq, spur_id, state->to_target[spur_id]);
+     while (!heap_is_empty(pq)) {
+         int current_id = heap_pop_min(pq, NULL);
+         side_settle(ws, fwd, current_id);
+         if (current_id == state->end_id) break;
+         for (int e = graph->edge_offsets[current_id]; e < graph->edge_offsets[current_id + 1]; e++) {
+             int neighbor_id = graph->edge_targets[e];
+             if (state->blocked[neighbor_id] == state->mark || state->to_target[neighbor_id] == DBL_MAX) continue;
+             if (current_id == spur_id && is_banned(state, neighbor_id)) continue;
+             if (side_is_settled(fwd, gen, neighbor_id)) continue;
+             side_touch(fwd, gen, neighbor_id);
+             double tentative = g_scores[current_id] + graph->edge_weights[e];
+             if (tentative < g_scores[neighbor_id]) {
+                 g_scores[neighbor_id] = tentative;
+                 fwd->predecessor[neighbor_id] = current_id;
+                 heap_push_or_decrease(pq, neighbor_id, tentative + state->to_target[neighbor_id]);
+             }
+         }
+     }
+     if (!side_reached(fwd, gen, state->end_id)) return 0;
+
+     int length = 0;
+     for (int v = state->end_id; v != -1; v = fwd->predecessor[v]) length++;
+     int slot = length;
+     for (int v = state->end_id; v != -1; v = fwd->predecessor[v]) state->spur_path[--slot] = v;
+     *cost = g_scores[state->end_id];
+     return length;
+ }
+
+ static bool same_path(const int* a, int a_length, const int* b, int b_length) {
+     return a_length == b_length && memcmp(a, b, (size_t)a_length * sizeof(int)) == 0;
+ }
+
+ // Takes the cheapest candidate out of the pool (earliest found on ties)
+ static Candidate pop_cheapest(Candidate* pool, int* pool_size) {
+     int best = 0;
+     for (int i = 1; i < *pool_size; i++) {
+         if (pool[i].cost < pool[best].cost) best = i;
+     }
+     Candidate cheapest = pool[best];
+     memmove(&pool[best], &pool[best + 1], (size_t)(*pool_size - best - 1) * sizeof(Candidate));
+     (*pool_size)--;
+     return cheapest;
+ }
+
+ int k_shortest_paths_ws(const Graph* graph, SearchWorkspace* ws, int start_id, int end_id, int k,
+                         PathResult* results) {
+     if (!ws || !results || k <= 0 || !is_valid_node(graph, start_id) || !is_valid_node(graph, end_id)) {
+         fprintf(stderr, "[KPaths Error] k_shortest_paths: Invalid workspace, results, k (%d) or nodes %d -> %d\n",
+                 k, start_id, end_id);
+         return -1;
+     }
+     if (!is_graph_frozen(graph)) {
+         fprintf(stderr, "[KPaths Error] k_shortest_paths: Graph is not frozen (call graph_freeze)\n");
+         return -1;
+     }
+     for (int i = 0; i < k; i++) results[i] = (PathResult){ .found = false };
+
+     int n = get_node_count(graph);
+     YenState state = { .graph = graph, .ws = ws, .end_id = end_id };
+     state.to_target = malloc((size_t)n * sizeof(double));
+     state.next_hop = malloc((size_t)n * sizeof(int));
+     state.blocked = calloc((size_t)n, sizeof(unsigned int));
+     state.banned = malloc((size_t)k * sizeof(int));
+     state.spur_path = malloc((size_t)n * sizeof(int));
+     double* prefix = malloc((size_t)n * sizeof(double));
+     int* deviations = malloc((size_t)k * sizeof(int));
+     int pool_size = 0, pool_capacity = 16;
+     Candidate* pool = malloc((size_t)pool_capacity * sizeof(Candidate));
+     int found = -1;
+     if (!state.to_target || !state.next_hop || !state.blocked || !state.banned || !state.spur_path || !prefix
+         || !deviations || !pool) {
+         fprintf(stderr, "[KPaths Error] k_shortest_paths: Failed to allocate state for %d nodes\n", n);
+         goto cleanup;
+     }
+
+     // Distances to the target over in-edges; predecessors become next hops
+     dijkstra_settle_all_ws(graph, ws, end_id, true, NULL);
+     for (int v = 0; v < n; v++) {
+         bool reached = side_reached(&ws->forward, ws->generation, v);
+         state.to_target[v] = reached ? ws->forward.distance[v] : DBL_MAX;
+         state.next_hop[v] = reached ? ws->forward.predecessor[v] : -1;
+     }
+     found = 0;
+     if (state.to_target[start_id] == DBL_MAX) goto cleanup;
+
+     int length = 0;
+     for (int v = start_id; v != -1; v = state.next_hop[v]) state.spur_path[length++] = v;
+     results[0].path = malloc((size_t)length * sizeof(int));
+     if (!results[0].path) {
+         fprintf(stderr, "[KPaths Error] k_shortest_paths: Failed to allocate path\n");
+         found = -1;
+         goto cleanup;
+     }
+     memcpy(results[0].path, state.spur_path, (size_t)length * sizeof(int));
+     results[0].path_length = length;
+     results[0].total_distance = state.to_target[start_id];
+     results[0].found = true;
+     results[0].owns_path = true;
+     deviations[0] = 0;
+     found = 1;
+
+     while (found < k) {
+         const PathResult* previous = &results[found - 1];
+         prefix[0] = 0.0;
+         for (int j = 0; j + 1 < previous->path_length; j++) {
+             prefix[j + 1] = prefix[j] + edge_weight(graph, previous->path[j], previous->path[j + 1]);
+         }
+
+         for (int j = deviations[found - 1]; j + 1 < previous->path_length; j++) {
+             int spur_id = previous->path[j];
+
+             // Block the root, and ban the next hop of every accepted path sharing it
+             if (++state.mark == 0) {
+                 memset(state.blocked, 0, (size_t)n * sizeof(unsigned int));
+                 state.mark = 1;
+             }
+             for (int r = 0; r < j; r++) state.blocked[previous->path[r]] = state.mark;
+             state.num_banned = 0;
+             for (int a = 0; a < found; a++) {
+                 if (results[a].path_length > j + 1
+                     && memcmp(results[a].path, previous->path, (size_t)(j + 1) * sizeof(int)) == 0) {
+                     state.banned[state.num_banned++] = results[a].path[j + 1];
+                 }
+             }
+
+             double spur_cost;
+             int spur_length = spur_search(&state, spur_id, &spur_cost);
+             if (spur_length == 0) continue;
+
+             Candidate candidate = { .length = j + spur_length, .deviation = j, .cost = prefix[j] + spur_cost };
+             candidate.path = malloc((size_t)candidate.length * sizeof(int));
+             if (!candidate.path) {
+                 fprintf(stderr, "[KPaths Error] k_shortest_paths: Failed to allocate candidate\n");
+                 found = -1;
+                 goto cleanup;
+             }
+             memcpy(candidate.path, previous->path, (size_t)j * sizeof(int));
+             memcpy(candidate.path + j, state.spur_path, (size_t)spur_length * sizeof(int));
+
+             bool duplicate = false;
+             for (int c = 0; c < pool_size && !duplicate; c++) {
+                 duplicate = same_path(pool[c].path, pool[c].length, candidate.path, candidate.length);
+             }
+             if (duplicate) {
+                 free(candidate.path);
+                 continue;
+             }
+             if (pool_size == pool_capacity) {
+                 Candidate* grown = realloc(pool, (size_t)pool_capacity * 2 * sizeof(Candidate));
+                 if (!grown) {
+                     fprintf(stderr, "[KPaths Error] k_shortest_paths: Failed to grow candidate pool\n");
+                     free(candidate.path);
+                     found = -1;
+                     goto cleanup;
+                 }
+                 pool = grown;
+                 pool_capacity *= 2;
+             }
+             pool[pool_size++] = candidate;
+         }
+
+         if (pool_size == 0) break;
+         Candidate next = pop_cheapest(pool, &pool_size);
+         results[found].path = next.path;
+         results[found].path_length = next.length;
+         results[found].total_distance = next.cost;
+         results[found].found = true;
+         results[found].owns_path = true;
+         deviations[found] = next.deviation;
+         found++;
+     }
+
+ cleanup:
+     if (found < 0) batch_free_results(results, k);
+     for (int c = 0; c < pool_size; c++) free(pool[c].path);
+     free(pool);
+     free(deviations);
+     free(prefix);
+     free(state.spur_path);
+     free(state.banned);
+     free(state.blocked);
+     free(state.next_hop);
+     free(state.to_target);
+     return found;
+ }
+
+ // One-shot queries use a temporary workspace
+ int k_shortest_paths(const Graph* graph, int start_id, int end_id, int k, PathResult* results) {
+     SearchWorkspace* ws = search_workspace_create(get_node_count(graph));
+     if (!ws) return -1;
+     int found = k_shortest_paths_ws(graph, ws, start_id, end_id, k, results);
+     search_workspace_destroy(ws);
+     return found;
+ }
@@ -0,0 +1,19 @@
+/*
+ * K Shortest Paths - Ranked loopless alternative routes (Yen's algorithm).
+ */
+
+ #ifndef KPATHS_H
+ #define KPATHS_H
+
+ #include "graph.h"
+ #include "algorithms.h"
+
+ // Fills results[0..k-1] with up to k loopless paths from start_id to end_id,
+ // shortest first. Every found path owns its array; release them with
+ // batch_free_results() or free_path_result(). Returns the number of paths
+ // found (0 if end_id is unreachable), or -1 on error.
+ int k_shortest_paths(const Graph* graph, int start_id, int end_id, int k, PathResult* results);
+ int k_shortest_paths_ws(const Graph* graph, SearchWorkspace* workspace, int start_id, int end_id, int k,
+                         PathResult* results);
+
+ #endif // KPATHS_H
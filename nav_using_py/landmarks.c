@@ -0,0 +1,311 @@
+/*
+ * ALT Landmarks Implementation
+ *
+ * For every landmark L the tables hold d(L, v) and d(v, L). By the triangle
+ * inequality both d(L, t) - d(L, v) and d(v, L) - d(t, L) are lower bounds on
+ * d(v, t); the heuristic takes the largest over all landmarks. Each term is
+ * consistent, so A* keeps its settled-node guarantee.
+ */
+
+ #include "landmarks.h"
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <float.h>
+
+ #define INFINITY_VAL DBL_MAX
+ #define LANDMARK_FILE_MAGIC "CNAVLMK"
+ #define LANDMARK_FILE_VERSION 1
+
+ typedef struct {
+     char magic[8];
+     uint32_t version;
+     int32_t num_nodes;
+     int32_t num_landmarks;
+     uint32_t reserved;
+     uint64_t graph_fingerprint;
+ } LandmarkFileHeader;
+
+ // Copies a full Dijkstra run into plain arrays (unreached nodes get INFINITY_VAL)
+ static int full_dijkstra(const Graph* graph, SearchWorkspace* ws, int source_id, bool reverse,
+                          double* distances, int* predecessors, int* order) {
+     int n = get_node_count(graph);
+     int settled = dijkstra_settle_all_ws(graph, ws, source_id, reverse, order);
+     const SearchSide* side = &ws->forward;
+     for (int i = 0; i < n; i++) {
+         bool reached = side_reached(side, ws->generation, i);
+         distances[i] = reached ? side->distance[i] : INFINITY_VAL;
+         if (predecessors) predecessors[i] = reached ? side->predecessor[i] : -1;
+     }
+     return settled;
+ }
+ 
+ double landmarks_lower_bound(const LandmarkSet* landmarks, int node_id, int end_id) {
+     double best = 0.0;
+     int n = landmarks->num_nodes;
+     for (int l = 0; l < landmarks->num_landmarks; l++) {
+         const double* from = landmarks->from_landmark + (size_t)l * n;
+         const double* to = landmarks->to_landmark + (size_t)l * n;
+         if (from[end_id] != INFINITY_VAL && from[node_id] != INFINITY_VAL) {
+             double bound = from[end_id] - from[node_id];
+             if (bound > best) best = bound;
+         }
+         if (to[node_id] != INFINITY_VAL && to[end_id] != INFINITY_VAL) {
+             double bound = to[node_id] - to[end_id];
+             if (bound > best) best = bound;
+         }
+     }
+     return best;
+ }
+
+ static double alt_heuristic(const void* context, int node_id, int end_id) {
+     return landmarks_lower_bound((const LandmarkSet*)context, node_id, end_id);
+ }
+
+ // Farthest: the reachable node whose nearest chosen landmark is furthest away
+ static int select_farthest(const LandmarkSet* set, int chosen, const double* root_distances) {
+     int n = set->num_nodes;
+     int best_node = -1;
+     double best_score = -1.0;
+     for (int v = 0; v < n; v++) {
+         if (root_distances[v] == INFINITY_VAL) continue;
+         double score = INFINITY_VAL;
+         for (int l = 0; l < chosen; l++) {
+             double d = set->from_landmark[(size_t)l * n + v];
+             if (d < score) score = d;
+         }
+         if (chosen == 0) score = root_distances[v];
+         if (score > best_score) {
+             best_score = score;
+             best_node = v;
+         }
+     }
+     return best_node;
+ }
+
+ // Avoid: weight each node of a shortest-path tree from a root by how badly the
+ // current landmarks bound its distance, then walk from the heaviest subtree
+ // without a landmark down to a leaf.
+ static int select_avoid(const LandmarkSet* set, int chosen, int root_id,
+                         const double* distances, const int* predecessors, const int* order, int settled) {
+     int n = set->num_nodes;
+     double* size = calloc(n, sizeof(double));
+     bool* covered = calloc(n, sizeof(bool));
+     int* heaviest_child = malloc(n * sizeof(int));
+     if (!size || !covered || !heaviest_child) {
+         free(size);
+         free(covered);
+         free(heaviest_child);
+         return -1;
+     }
+     for (int i = 0; i < n; i++) heaviest_child[i] = -1;
+     for (int l = 0; l < chosen; l++) covered[set->landmark_ids[l]] = true;
+
+     // Children follow parents in settle order, so a reverse sweep sees subtrees first
+     for (int i = settled - 1; i >= 0; i--) {
+         int v = order[i];
+         if (!covered[v]) {
+             double gap = distances[v] - (chosen > 0 ? landmarks_lower_bound(set, root_id, v) : 0.0);
+             size[v] += gap;
+         }
+         int parent = predecessors[v];
+         if (parent == -1) continue;
+         if (covered[v]) {
+             covered[parent] = true;
+             continue;
+         }
+         size[parent] += size[v];
+         if (heaviest_child[parent] == -1 || size[v] > size[heaviest_child[parent]]) heaviest_child[parent] = v;
+     }
+
+     int best_node = -1;
+     for (int i = 0; i < settled; i++) {
+         int v = order[i];
+         if (covered[v]) continue;
+         if (best_node == -1 || size[v] > size[best_node]) best_node = v;
+     }
+     while (best_node != -1 && heaviest_child[best_node] != -1 && !covered[heaviest_child[best_node]]) {
+         best_node = heaviest_child[best_node];
+     }
+
+     free(size);
+     free(covered);
+     free(heaviest_child);
+     return best_node;
+ }
+
+ static LandmarkSet* landmarks_allocate(int num_nodes, int count) {
+     LandmarkSet* set = calloc(1, sizeof(LandmarkSet));
+     if (!set) return NULL;
+     set->num_nodes = num_nodes;
+     set->num_landmarks = count;
+     set->landmark_ids = malloc((count > 0 ? count : 1) * sizeof(int));
+     set->from_landmark = malloc(((size_t)count * num_nodes + 1) * sizeof(double));
+     set->to_landmark = malloc(((size_t)count * num_nodes + 1) * sizeof(double));
+     if (!set->landmark_ids || !set->from_landmark || !set->to_landmark) {
+         landmarks_destroy(set);
+         return NULL;
+     }
+     return set;
+ }
+
+ LandmarkSet* landmarks_build(const Graph* graph, int count, LandmarkSelection selection) {
+     if (!is_graph_frozen(graph)) {
+         fprintf(stderr, "[Landmark Error] landmarks_build: Graph is NULL or not frozen (call graph_freeze)\n");
+         return NULL;
+     }
+     int n = get_node_count(graph);
+     if (count > n) count = n;
+     if (count <= 0) {
+         fprintf(stderr, "[Landmark Error] landmarks_build: Invalid landmark count %d\n", count);
+         return NULL;
+     }
+
+     LandmarkSet* set = landmarks_allocate(n, count);
+     SearchWorkspace* ws = search_workspace_create(n);
+     double* root_distances = malloc(n * sizeof(double));
+     int* predecessors = malloc(n * sizeof(int));
+     int* order = malloc(n * sizeof(int));
+     if (!set || !ws || !root_distances || !predecessors || !order) {
+         fprintf(stderr, "[Landmark Error] landmarks_build: Failed to allocate tables for %d landmarks\n", count);
+         landmarks_destroy(set);
+         set = NULL;
+         goto cleanup;
+     }
+     set->graph_fingerprint = graph_fingerprint(graph);
+     set->graph_version = graph_version(graph);
+
+     int chosen = 0;
+     while (chosen < count) {
+         // Root the selection at a node far from the current set (node 0 to start)
+         int root_id = chosen == 0 ? 0 : set->landmark_ids[chosen - 1];
+         int settled = full_dijkstra(graph, ws, root_id, false, root_distances, predecessors, order);
+
+         int landmark_id = selection == LANDMARKS_AVOID
+             ? select_avoid(set, chosen, root_id, root_distances, predecessors, order, settled)
+             : select_farthest(set, chosen, root_distances);
+         if (landmark_id == -1) break;
+         bool duplicate = false;
+         for (int l = 0; l < chosen; l++) duplicate = duplicate || set->landmark_ids[l] == landmark_id;
+         if (duplicate) break;
+
+         set->landmark_ids[chosen] = landmark_id;
+         full_dijkstra(graph, ws, landmark_id, false, set->from_landmark + (size_t)chosen * n, NULL, NULL);
+         full_dijkstra(graph, ws, landmark_id, true, set->to_landmark + (size_t)chosen * n, NULL, NULL);
+         chosen++;
+     }
+     set->num_landmarks = chosen;
+
+ cleanup:
+     search_workspace_destroy(ws);
+     free(root_distances);
+     free(predecessors);
+     free(order);
+     return set;
+ }
+
+ void landmarks_destroy(LandmarkSet* set) {
+     if (!set) return;
+     free(set->landmark_ids);
+     free(set->from_landmark);
+     free(set->to_landmark);
+     free(set);
+ }
+
+ bool landmarks_save(const LandmarkSet* set, const char* filename) {
+     if (!set || !filename) return false;
+     FILE* file = fopen(filename, "wb");
+     if (!file) {
+         fprintf(stderr, "[Landmark Error] landmarks_save: Could not open file '%s'.\n", filename);
+         return false;
+     }
+
+     LandmarkFileHeader header = { .version = LANDMARK_FILE_VERSION };
+     memcpy(header.magic, LANDMARK_FILE_MAGIC, sizeof(header.magic));
+     header.num_nodes = set->num_nodes;
+     header.num_landmarks = set->num_landmarks;
+     header.graph_fingerprint = set->graph_fingerprint;
+
+     size_t table = (size_t)set->num_landmarks * set->num_nodes;
+     bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+               && fwrite(set->landmark_ids, sizeof(int), set->num_landmarks, file) == (size_t)set->num_landmarks
+               && fwrite(set->from_landmark, sizeof(double), table, file) == table
+               && fwrite(set->to_landmark, sizeof(double), table, file) == table;
+     if (fclose(file) != 0) ok = false;
+     if (!ok) fprintf(stderr, "[Landmark Error] landmarks_save: Failed to write '%s'.\n", filename);
+     return ok;
+ }
+
+ LandmarkSet* landmarks_load(const Graph* graph, const char* filename) {
+     if (!is_graph_frozen(graph) || !filename) return NULL;
+     FILE* file = fopen(filename, "rb");
+     if (!file) return NULL;
+
+     LandmarkFileHeader header;
+     LandmarkSet* set = NULL;
+     if (fread(&header, sizeof(header), 1, file) != 1
+         || memcmp(header.magic, LANDMARK_FILE_MAGIC, sizeof(header.magic)) != 0
+         || header.version != LANDMARK_FILE_VERSION) {
+         fprintf(stderr, "[Landmark Error] landmarks_load: '%s' is not a landmark file.\n", filename);
+         fclose(file);
+         return NULL;
+     }
+     if (header.num_nodes != get_node_count(graph) || header.graph_fingerprint != graph_fingerprint(graph)) {
+         fprintf(stderr, "[Landmark Error] landmarks_load: '%s' was built for a different graph.\n", filename);
+         fclose(file);
+         return NULL;
+     }
+     if (header.num_landmarks <= 0 || header.num_landmarks > header.num_nodes) {
+         fprintf(stderr, "[Landmark Error] landmarks_load: '%s' has an invalid landmark count %d.\n", filename,
+                 header.num_landmarks);
+         fclose(file);
+         return NULL;
+     }
+
+     set = landmarks_allocate(header.num_nodes, header.num_landmarks);
+     if (set) {
+         set->graph_fingerprint = header.graph_fingerprint;
+         set->graph_version = graph_version(graph);
+         size_t table = (size_t)set->num_landmarks * set->num_nodes;
+         bool ok = fread(set->landmark_ids, sizeof(int), set->num_landmarks, file) == (size_t)set->num_landmarks
+                   && fread(set->from_landmark, sizeof(double), table, file) == table
+                   && fread(set->to_landmark, sizeof(double), table, file) == table;
+         if (!ok) fprintf(stderr, "[Landmark Error] landmarks_load: '%s' is truncated.\n", filename);
+         for (int i = 0; ok && i < set->num_landmarks; i++) {
+             if (set->landmark_ids[i] < 0 || set->landmark_ids[i] >= set->num_nodes) {
+                 fprintf(stderr, "[Landmark Error] landmarks_load: '%s' has an invalid landmark id %d.\n", filename,
+                         set->landmark_ids[i]);
+                 ok = false;
+             }
+         }
+         if (!ok) {
+             landmarks_destroy(set);
+             set = NULL;
+         }
+     }
+     fclose(file);
+     return set;
+ }
+
+ PathResult alt_shortest_path_ws(const Graph* graph, const LandmarkSet* landmarks, SearchWorkspace* ws,
+                                 int start_id, int end_id) {
+     PathResult result = { .found = false };
+     if (!landmarks || landmarks->num_nodes != get_node_count(graph)) {
+         fprintf(stderr, "[Landmark Error] alt_shortest_path: Landmarks missing or built for a different graph\n");
+         return result;
+     }
+     if (graph_version(graph) != landmarks->graph_version) {
+         fprintf(stderr, "[Landmark Error] alt_shortest_path: Graph changed, rebuild the landmarks\n");
+         return result;
+     }
+     return a_star_shortest_path_with(graph, ws, start_id, end_id, alt_heuristic, landmarks);
+ }
+
+ PathResult alt_shortest_path(const Graph* graph, const LandmarkSet* landmarks, int start_id, int end_id) {
+     PathResult result = { .found = false };
+     SearchWorkspace* ws = search_workspace_create(get_node_count(graph));
+     if (!ws) return result;
+     result = alt_shortest_path_ws(graph, landmarks, ws, start_id, end_id);
+     search_workspace_destroy(ws);
+     return result;
+ }
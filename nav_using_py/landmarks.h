@@ -0,0 +1,41 @@
+/*
+ * ALT Landmarks - A*, Landmarks and the Triangle inequality.
+ */
+
+ #ifndef LANDMARKS_H
+ #define LANDMARKS_H
+
+ #include "graph.h"
+ #include "algorithms.h"
+
+ typedef enum {
+     LANDMARKS_FARTHEST,   // Each landmark maximises its distance to the ones already chosen
+     LANDMARKS_AVOID       // Goldberg-Werneck "avoid": targets regions the current set covers badly
+ } LandmarkSelection;
+
+ typedef struct {
+     int num_landmarks;
+     int num_nodes;
+     uint64_t graph_fingerprint;
+     uint64_t graph_version;  // Graph version at build or load time; queries fail once it changes
+     int* landmark_ids;
+     double* from_landmark;   // [l * num_nodes + v] = d(landmark l, v)
+     double* to_landmark;     // [l * num_nodes + v] = d(v, landmark l)
+ } LandmarkSet;
+
+ // Lifecycle Management
+ LandmarkSet* landmarks_build(const Graph* graph, int count, LandmarkSelection selection);
+ void landmarks_destroy(LandmarkSet* landmarks);
+
+ // File I/O (rejects files built for a different graph)
+ bool landmarks_save(const LandmarkSet* landmarks, const char* filename);
+ LandmarkSet* landmarks_load(const Graph* graph, const char* filename);
+
+ // Queries. A live update can make the bounds overestimate, so after one the
+ // routes log an error and find nothing until the landmarks are rebuilt.
+ double landmarks_lower_bound(const LandmarkSet* landmarks, int node_id, int end_id);
+ PathResult alt_shortest_path(const Graph* graph, const LandmarkSet* landmarks, int start_id, int end_id);
+ PathResult alt_shortest_path_ws(const Graph* graph, const LandmarkSet* landmarks, SearchWorkspace* workspace,
+                                 int start_id, int end_id);
+
+ #endif // LANDMARKS_H
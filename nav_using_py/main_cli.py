@@ -2,21 +2,47 @@ import os
 import ctypes
 import webbrowser
 import sys
-from navigator_wrapper import lib, Graph, Node, PathResult, decode_str
+from navigator_wrapper import (lib, Graph, Node, PathResult, decode_str, complete_name, reachable_within,
+                               GRAPH_DEFAULT_CAPACITY,
+                               ALGO_DIJKSTRA, ALGO_A_STAR,
+                               ALGO_BIDIRECTIONAL_DIJKSTRA, ALGO_BIDIRECTIONAL_A_STAR)
 
 # Configuration
 MAP_FILE = "dehradun_campus.txt"
 OUTPUT_HTML = "campus_map.html"
 
-def get_valid_int(prompt, max_val):
+def get_valid_int(prompt, max_val, spatial=None, names=None):
     while True:
+        text = input(prompt)
         try:
-            val = int(input(prompt))
+            if spatial and "," in text:
+                # "latitude,longitude" snaps to the nearest node
+                lat, lon = (float(part) for part in text.split(","))
+                distance = ctypes.c_double()
+                val = lib.spatial_nearest(spatial, lat, lon, ctypes.byref(distance))
+                if val != -1:
+                    print(f"  Nearest node: {val}, {distance.value * 1000:.0f} m away")
+                    return val
+                print("Error: The map has no nodes.")
+                continue
+            if names and not text.strip().lstrip("-").isdigit():
+                # Anything else that is not a number is looked up as a node name
+                val = lib.name_index_find(names, text.strip().encode('utf-8'))
+                if val != -1:
+                    print(f"  Matched node: {val}")
+                    return val
+                suggestions = complete_name(names, text.strip(), 5)
+                if suggestions:
+                    print("  Did you mean: " + ", ".join(str(i) for i in suggestions))
+                else:
+                    print("Error: No node has that name.")
+                continue
+            val = int(text)
             if 0 <= val < max_val:
                 return val
             print(f"Error: Please enter a number between 0 and {max_val-1}.")
         except ValueError:
-            print("Error: Invalid input. Please enter a number.")
+            print("Error: Invalid input. Please enter a number, a name, or latitude,longitude.")
 
 def main():
     print("")
@@ -25,7 +51,7 @@ def main():
 
     # 1. Initialize C Graph
     print(f"Loading C Library from: {os.path.abspath('libnavigator.so')}")
-    graph = lib.create_graph(250)
+    graph = lib.create_graph(GRAPH_DEFAULT_CAPACITY)
     if not graph:
         print("Error: Failed to create C Graph memory.")
         return
@@ -43,35 +69,43 @@ def main():
         print("Error: Failed to load map data via C library.")
         return
 
-    num_nodes = graph.contents.num_nodes
+    num_nodes = lib.get_node_count(graph)
     print(f"Map Loaded Successfully! ({num_nodes} nodes)")
 
     # 3. Display Nodes
     print("\n--- Available Locations ---")
     for i in range(num_nodes):
-        node_ptr = lib.get_node(graph, i)
-        if node_ptr:
-            name = decode_str(node_ptr.contents.name)
-            print(f"  [{i}] {name}")
+        name = lib.get_node_name(graph, i)
+        if name is not None:
+            print(f"  [{i}] {decode_str(name)}")
     print("---------------------------")
 
-    # 4. Get User Input
-    start_id = get_valid_int("\nEnter Start Node ID: ", num_nodes)
-    end_id = get_valid_int("Enter End Node ID:   ", num_nodes)
+    # 4. Get User Input (a node ID, a name, or latitude,longitude snapped to the nearest node)
+    spatial = lib.spatial_index_build(graph)
+    names = lib.name_index_build(graph)
+    start_id = get_valid_int("\nEnter Start Node ID: ", num_nodes, spatial, names)
+    end_id = get_valid_int("Enter End Node ID:   ", num_nodes, spatial, names)
+    lib.spatial_index_destroy(spatial)
+    lib.name_index_destroy(names)
 
     print("\nSelect Algorithm:")
     print("  1. Dijkstra (Standard)")
     print("  2. A* (Optimized)")
-    algo_choice = input("Enter choice (1 or 2): ").strip()
+    print("  3. Bidirectional Dijkstra")
+    print("  4. Bidirectional A*")
+    algo_choice = input("Enter choice (1-4): ").strip()
+    algorithms = {
+        "1": ALGO_DIJKSTRA,
+        "2": ALGO_A_STAR,
+        "3": ALGO_BIDIRECTIONAL_DIJKSTRA,
+        "4": ALGO_BIDIRECTIONAL_A_STAR,
+    }
+    algorithm = algorithms.get(algo_choice, ALGO_DIJKSTRA)
 
     # 5. Run C Algorithm
     print("\nCalculating path in C...")
-    if algo_choice == "2":
-        result = lib.a_star_shortest_path(graph, start_id, end_id)
-        method = "A*"
-    else:
-        result = lib.dijkstra_shortest_path(graph, start_id, end_id)
-        method = "Dijkstra"
+    result = lib.find_shortest_path(graph, algorithm, start_id, end_id)
+    method = decode_str(lib.search_algorithm_name(algorithm))
 
     if not result.found:
         print("\nNo path found between these locations.")
@@ -87,15 +121,26 @@ def main():
 
     print(f" Route Found via {method}!")
     print(f"   Total Distance: {dist_km:.3f} km")
+
+    # Optional area within walking distance of the start
+    area = None
+    radius_text = input("\nShade the area within how many metres of the start? (Enter to skip): ").strip()
+    try:
+        if radius_text:
+            area = reachable_within(graph, start_id, float(radius_text) / 1000.0)
+            if area:
+                print(f"   {len(area[0])} locations within {float(radius_text):.0f} m")
+    except ValueError:
+        print("Error: Not a distance, skipping the area.")
     
     # 7. Generate Map
-    generate_map(graph, path_ids, dist_km)
+    generate_map(graph, path_ids, dist_km, area)
     
     # Cleanup
     lib.free_path_result(ctypes.byref(result))
     lib.destroy_graph(graph)
 
-def generate_map(graph, path_ids, distance):
+def generate_map(graph, path_ids, distance, area=None):
     import folium
     
     # Get start node for centering
@@ -105,6 +150,18 @@ def generate_map(graph, path_ids, distance):
 
     m = folium.Map(location=[center_lat, center_lon], zoom_start=18)
 
+    # Reachable area beneath the route: (reached nodes, outline) from reachable_within
+    if area:
+        reached, outline = area
+        if len(outline) >= 3:
+            folium.Polygon(outline, color="green", weight=2, fill=True, fill_opacity=0.15).add_to(m)
+        for node_id, node_distance in reached:
+            n = lib.get_node(graph, node_id)
+            folium.CircleMarker(
+                location=[n.contents.latitude, n.contents.longitude], radius=5, color="green",
+                popup=f"{decode_str(lib.get_node_name(graph, node_id))}: {node_distance * 1000:.0f} m"
+            ).add_to(m)
+
     # Draw Path
     route_coords = []
     for pid in path_ids:
@@ -114,7 +171,7 @@ def generate_map(graph, path_ids, distance):
         # Small marker for intermediate nodes
         folium.CircleMarker(
             location=[n.contents.latitude, n.contents.longitude],
-            radius=3, color="red", fill=True, popup=decode_str(n.contents.name)
+            radius=3, color="red", fill=True, popup=decode_str(lib.get_node_name(graph, pid))
         ).add_to(m)
 
     folium.PolyLine(route_coords, color="red", weight=5, opacity=0.8).add_to(m)
@@ -125,13 +182,13 @@ def generate_map(graph, path_ids, distance):
 
     folium.Marker(
         [start_n.contents.latitude, start_n.contents.longitude],
-        popup=f"Start: {decode_str(start_n.contents.name)}",
+        popup=f"Start: {decode_str(lib.get_node_name(graph, path_ids[0]))}",
         icon=folium.Icon(color='green', icon='play')
     ).add_to(m)
 
     folium.Marker(
         [end_n.contents.latitude, end_n.contents.longitude],
-        popup=f"End: {decode_str(end_n.contents.name)}\nDist: {distance:.2f}km",
+        popup=f"End: {decode_str(lib.get_node_name(graph, path_ids[-1]))}\nDist: {distance:.2f}km",
         icon=folium.Icon(color='black', icon='stop')
     ).add_to(m)
 
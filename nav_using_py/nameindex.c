@@ -0,0 +1,129 @@
+/*
+ * Name Index Implementation
+ *
+ * Every named node gets an entry holding its folded name, and the entries are
+ * sorted once at build time. Both queries are a binary search: nodes sharing
+ * a prefix are adjacent in the sorted array, and an exact match is the first
+ * of them, so a lookup costs about log2(n) short string compares.
+ */
+
+ #include "nameindex.h"
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+
+ static inline unsigned char fold(unsigned char c) {
+     if (c == '_') return ' ';
+     return (c >= 'A' && c <= 'Z') ? (unsigned char)(c + ('a' - 'A')) : c;
+ }
+
+ static int compare_entries(const void* a, const void* b) {
+     const NameEntry* x = a;
+     const NameEntry* y = b;
+     int order = strcmp(x->key, y->key);
+     if (order != 0) return order;
+     return (x->node_id > y->node_id) - (x->node_id < y->node_id);
+ }
+
+ NameIndex* name_index_build(const Graph* graph) {
+     if (!graph) {
+         fprintf(stderr, "[NameIndex Error] name_index_build: Graph is NULL\n");
+         return NULL;
+     }
+     int n = get_node_count(graph);
+     NameIndex* index = malloc(sizeof(NameIndex));
+     if (!index) {
+         fprintf(stderr, "[NameIndex Error] name_index_build: Failed to allocate index\n");
+         return NULL;
+     }
+     index->num_entries = 0;
+     arena_init(&index->arena);
+     index->entries = malloc((n > 0 ? (size_t)n : 1) * sizeof(NameEntry));
+     // Folded name per name ID, so nodes that share a name share one copy
+     const char** folded = calloc(graph->names.count > 0 ? (size_t)graph->names.count : 1, sizeof(const char*));
+     if (!index->entries || !folded) {
+         fprintf(stderr, "[NameIndex Error] name_index_build: Failed to allocate index for %d nodes\n", n);
+         free(folded);
+         name_index_destroy(index);
+         return NULL;
+     }
+
+     for (int i = 0; i < n; i++) {
+         int name_id = graph->nodes[i].name_id;
+         if (!folded[name_id]) {
+             const char* name = graph_name(graph, name_id);
+             size_t length = strlen(name);
+             char* key = arena_alloc(&index->arena, length + 1);
+             if (!key) {
+                 fprintf(stderr, "[NameIndex Error] name_index_build: Failed to copy node names\n");
+                 free(folded);
+                 name_index_destroy(index);
+                 return NULL;
+             }
+             for (size_t c = 0; c <= length; c++) key[c] = (char)fold((unsigned char)name[c]);
+             folded[name_id] = key;
+         }
+         if (folded[name_id][0] == '\0') continue;   // Unnamed nodes are not searchable
+         index->entries[index->num_entries].key = folded[name_id];
+         index->entries[index->num_entries].node_id = i;
+         index->num_entries++;
+     }
+     free(folded);
+
+     qsort(index->entries, index->num_entries, sizeof(NameEntry), compare_entries);
+     return index;
+ }
+
+ void name_index_destroy(NameIndex* index) {
+     if (!index) return;
+     free(index->entries);
+     arena_free(&index->arena);
+     free(index);
+ }
+
+ // Orders a folded key against an unfolded query; 0 when the key starts with it
+ static int compare_prefix(const char* key, const char* query) {
+     for (size_t i = 0; query[i] != '\0'; i++) {
+         unsigned char a = (unsigned char)key[i];
+         unsigned char b = fold((unsigned char)query[i]);
+         if (a != b) return a < b ? -1 : 1;
+     }
+     return 0;
+ }
+
+ // First entry whose key does not sort before the query's prefix range
+ static int lower_bound(const NameIndex* index, const char* query) {
+     int lo = 0, hi = index->num_entries;
+     while (lo < hi) {
+         int mid = lo + (hi - lo) / 2;
+         if (compare_prefix(index->entries[mid].key, query) < 0) lo = mid + 1;
+         else hi = mid;
+     }
+     return lo;
+ }
+
+ int name_index_find(const NameIndex* index, const char* name) {
+     if (!index || !name) {
+         fprintf(stderr, "[NameIndex Error] name_index_find: Index or name is NULL\n");
+         return -1;
+     }
+     if (name[0] == '\0') return -1;
+     int at = lower_bound(index, name);
+     if (at == index->num_entries) return -1;
+     const NameEntry* entry = &index->entries[at];
+     if (compare_prefix(entry->key, name) != 0 || entry->key[strlen(name)] != '\0') return -1;
+     return entry->node_id;
+ }
+
+ int name_index_complete(const NameIndex* index, const char* prefix, int max_results, int* node_ids) {
+     if (!index || !prefix || max_results < 0 || (max_results > 0 && !node_ids)) {
+         fprintf(stderr, "[NameIndex Error] name_index_complete: Index or output is NULL, or max_results is negative\n");
+         return -1;
+     }
+     int count = 0;
+     for (int at = lower_bound(index, prefix); at < index->num_entries && count < max_results; at++) {
+         if (compare_prefix(index->entries[at].key, prefix) != 0) break;
+         node_ids[count++] = index->entries[at].node_id;
+     }
+     return count;
+ }
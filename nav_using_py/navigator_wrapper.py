@@ -11,9 +11,9 @@ lib = ctypes.CDLL(lib_path)
 class Node(ctypes.Structure):
     _fields_ = [
         ("id", ctypes.c_int),
+        ("name_id", ctypes.c_int),
         ("latitude", ctypes.c_double),
-        ("longitude", ctypes.c_double),
-        ("name", ctypes.c_char * 64)
+        ("longitude", ctypes.c_double)
     ]
 
 class Edge(ctypes.Structure):
@@ -21,18 +21,84 @@ class Edge(ctypes.Structure):
 
 Edge._fields_ = [
     ("destination_id", ctypes.c_int),
+    ("road_name_id", ctypes.c_int),
     ("weight", ctypes.c_double),
-    ("road_name", ctypes.c_char * 32),
     ("next", ctypes.POINTER(Edge))
 ]
 
+class Arena(ctypes.Structure):
+    _fields_ = [
+        ("head", ctypes.c_void_p),
+        ("next_block_size", ctypes.c_size_t),
+        ("bytes_used", ctypes.c_size_t)
+    ]
+
+class StringTable(ctypes.Structure):
+    _fields_ = [
+        ("strings", ctypes.POINTER(ctypes.c_char_p)),
+        ("hashes", ctypes.POINTER(ctypes.c_uint32)),
+        ("count", ctypes.c_int),
+        ("capacity", ctypes.c_int),
+        ("slots", ctypes.POINTER(ctypes.c_int)),
+        ("slot_capacity", ctypes.c_int),
+        ("arena", Arena)
+    ]
+
+class GraphChange(ctypes.Structure):
+    _fields_ = [
+        ("source_id", ctypes.c_int),
+        ("destination_id", ctypes.c_int),
+        ("old_weight", ctypes.c_double),
+        ("new_weight", ctypes.c_double),
+        ("version", ctypes.c_uint64)
+    ]
+
+class ClosedEdge(ctypes.Structure):
+    _fields_ = [
+        ("source_id", ctypes.c_int),
+        ("destination_id", ctypes.c_int),
+        ("weights", ctypes.POINTER(ctypes.c_double)),
+        ("num_weights", ctypes.c_int)
+    ]
+
+class GraphUpdate(ctypes.Structure):
+    _fields_ = [
+        ("kind", ctypes.c_int),
+        ("source_id", ctypes.c_int),
+        ("destination_id", ctypes.c_int),
+        ("weight", ctypes.c_double)
+    ]
+
 class Graph(ctypes.Structure):
     _fields_ = [
         ("nodes", ctypes.POINTER(Node)),
         ("adjacency_list", ctypes.POINTER(ctypes.POINTER(Edge))),
         ("num_nodes", ctypes.c_int),
         ("num_edges", ctypes.c_int),
-        ("capacity", ctypes.c_int)
+        ("capacity", ctypes.c_int),
+        ("version", ctypes.c_uint64),
+        ("latitudes", ctypes.POINTER(ctypes.c_double)),
+        ("longitudes", ctypes.POINTER(ctypes.c_double)),
+        ("unit_vectors", ctypes.POINTER(ctypes.c_double)),
+        ("frozen", ctypes.c_bool),
+        ("edge_offsets", ctypes.POINTER(ctypes.c_int)),
+        ("edge_targets", ctypes.POINTER(ctypes.c_int)),
+        ("edge_weights", ctypes.POINTER(ctypes.c_double)),
+        ("rev_edge_offsets", ctypes.POINTER(ctypes.c_int)),
+        ("rev_edge_sources", ctypes.POINTER(ctypes.c_int)),
+        ("rev_edge_weights", ctypes.POINTER(ctypes.c_double)),
+        ("mapping", ctypes.c_void_p),
+        ("mapping_size", ctypes.c_size_t),
+        ("arena", Arena),
+        ("names", StringTable),
+        ("changes", ctypes.POINTER(GraphChange)),
+        ("num_changes", ctypes.c_int),
+        ("changes_capacity", ctypes.c_int),
+        ("changes_base", ctypes.c_uint64),
+        ("closed_edges", ctypes.POINTER(ClosedEdge)),
+        ("num_closed_edges", ctypes.c_int),
+        ("closed_edges_capacity", ctypes.c_int),
+        ("weight_copy", ctypes.POINTER(ctypes.c_double))
     ]
 
 class PathResult(ctypes.Structure):
@@ -40,15 +106,132 @@ class PathResult(ctypes.Structure):
         ("path", ctypes.POINTER(ctypes.c_int)),
         ("path_length", ctypes.c_int),
         ("total_distance", ctypes.c_double),
-        ("found", ctypes.c_bool)
+        ("found", ctypes.c_bool),
+        ("owns_path", ctypes.c_bool)
+    ]
+
+class SharedRoute(ctypes.Structure):
+    _fields_ = [
+        ("result", PathResult),
+        ("refcount", ctypes.c_int)
+    ]
+
+class RouteCacheStats(ctypes.Structure):
+    _fields_ = [
+        ("hits", ctypes.c_uint64),
+        ("misses", ctypes.c_uint64),
+        ("evictions", ctypes.c_uint64),
+        ("invalidations", ctypes.c_uint64),
+        ("size", ctypes.c_int),
+        ("capacity", ctypes.c_int)
+    ]
+
+class RoutePair(ctypes.Structure):
+    _fields_ = [
+        ("start_id", ctypes.c_int),
+        ("end_id", ctypes.c_int)
+    ]
+
+class ShortestPathTree(ctypes.Structure):
+    _fields_ = [
+        ("source_id", ctypes.c_int),
+        ("num_nodes", ctypes.c_int),
+        ("num_reached", ctypes.c_int),
+        ("distances", ctypes.POINTER(ctypes.c_double)),
+        ("predecessors", ctypes.POINTER(ctypes.c_int)),
+        ("order", ctypes.POINTER(ctypes.c_int)),
+        ("graph_version", ctypes.c_uint64)
+    ]
+
+class ProfilePoint(ctypes.Structure):
+    _fields_ = [
+        ("time", ctypes.c_float),
+        ("factor", ctypes.c_float)
     ]
 
+class TravelProfile(ctypes.Structure):
+    _fields_ = [
+        ("first_point", ctypes.c_int),
+        ("num_points", ctypes.c_int),
+        ("min_slope", ctypes.c_float)
+    ]
+
+class TimeProfiles(ctypes.Structure):
+    _fields_ = [
+        ("num_nodes", ctypes.c_int),
+        ("num_edges", ctypes.c_int),
+        ("seconds_per_km", ctypes.c_double),
+        ("min_factor", ctypes.c_double),
+        ("num_profiles", ctypes.c_int),
+        ("profiles", ctypes.POINTER(TravelProfile)),
+        ("num_points", ctypes.c_int),
+        ("points", ctypes.POINTER(ProfilePoint)),
+        ("edge_profiles", ctypes.POINTER(ctypes.c_uint16))
+    ]
+
+class ReachedNode(ctypes.Structure):
+    _fields_ = [
+        ("node_id", ctypes.c_int),
+        ("distance", ctypes.c_double)
+    ]
+
+class EdgeCut(ctypes.Structure):
+    _fields_ = [
+        ("source_id", ctypes.c_int),
+        ("destination_id", ctypes.c_int),
+        ("fraction", ctypes.c_double),
+        ("latitude", ctypes.c_double),
+        ("longitude", ctypes.c_double)
+    ]
+
+class Isochrone(ctypes.Structure):
+    _fields_ = [
+        ("source_id", ctypes.c_int),
+        ("max_distance", ctypes.c_double),
+        ("num_reached", ctypes.c_int),
+        ("reached", ctypes.POINTER(ReachedNode)),
+        ("num_cuts", ctypes.c_int),
+        ("cuts", ctypes.POINTER(EdgeCut)),
+        ("num_outline", ctypes.c_int),
+        ("outline", ctypes.POINTER(ctypes.c_double))
+    ]
+
+# Initial node slots for create_graph (graph.h); the graph grows past this as needed
+GRAPH_DEFAULT_CAPACITY = 256
+
+# GraphUpdateKind enum values (graph.h)
+GRAPH_UPDATE_SET_WEIGHT = 0
+GRAPH_UPDATE_CLOSE = 1
+GRAPH_UPDATE_OPEN = 2
+
+# SearchAlgorithm enum values (algorithms.h)
+ALGO_DIJKSTRA = 0
+ALGO_A_STAR = 1
+ALGO_BIDIRECTIONAL_DIJKSTRA = 2
+ALGO_BIDIRECTIONAL_A_STAR = 3
+
+# LandmarkSelection enum values (landmarks.h)
+LANDMARKS_FARTHEST = 0
+LANDMARKS_AVOID = 1
+
 # 3. Define Argument and Return Types for C Functions
 
 # Graph* create_graph(int capacity);
 lib.create_graph.argtypes = [ctypes.c_int]
 lib.create_graph.restype = ctypes.POINTER(Graph)
 
+# bool graph_reserve(Graph* graph, int capacity);
+lib.graph_reserve.argtypes = [ctypes.POINTER(Graph), ctypes.c_int]
+lib.graph_reserve.restype = ctypes.c_bool
+
+# int get_node_count(const Graph* graph);
+lib.get_node_count.argtypes = [ctypes.POINTER(Graph)]
+lib.get_node_count.restype = ctypes.c_int
+
+# const char* get_node_name(const Graph* graph, int node_id);
+lib.get_node_name.argtypes = [ctypes.POINTER(Graph), ctypes.c_int]
+lib.get_node_name.restype = ctypes.c_char_p
+
 # void destroy_graph(Graph* graph);
 lib.destroy_graph.argtypes = [ctypes.POINTER(Graph)]
 
@@ -56,6 +239,18 @@ lib.destroy_graph.argtypes = [ctypes.POINTER(Graph)]
 lib.load_road_network.argtypes = [ctypes.POINTER(Graph), ctypes.c_char_p]
 lib.load_road_network.restype = ctypes.c_bool
 
+# bool load_binary_map(Graph* graph, const char* filename);
+lib.load_binary_map.argtypes = [ctypes.POINTER(Graph), ctypes.c_char_p]
+lib.load_binary_map.restype = ctypes.c_bool
+
+# bool save_binary_map(const Graph* graph, const char* filename);
+lib.save_binary_map.argtypes = [ctypes.POINTER(Graph), ctypes.c_char_p]
+lib.save_binary_map.restype = ctypes.c_bool
+
+# bool graph_freeze(Graph* graph);
+lib.graph_freeze.argtypes = [ctypes.POINTER(Graph)]
+lib.graph_freeze.restype = ctypes.c_bool
+
 # const Node* get_node(const Graph* graph, int node_id);
 lib.get_node.argtypes = [ctypes.POINTER(Graph), ctypes.c_int]
 lib.get_node.restype = ctypes.POINTER(Node)
@@ -68,9 +263,331 @@ lib.dijkstra_shortest_path.restype = PathResult
 lib.a_star_shortest_path.argtypes = [ctypes.POINTER(Graph), ctypes.c_int, ctypes.c_int]
 lib.a_star_shortest_path.restype = PathResult
 
+# PathResult bidirectional_dijkstra_shortest_path(const Graph* graph, int start_id, int end_id);
+lib.bidirectional_dijkstra_shortest_path.argtypes = [ctypes.POINTER(Graph), ctypes.c_int, ctypes.c_int]
+lib.bidirectional_dijkstra_shortest_path.restype = PathResult
+
+# PathResult bidirectional_a_star_shortest_path(const Graph* graph, int start_id, int end_id);
+lib.bidirectional_a_star_shortest_path.argtypes = [ctypes.POINTER(Graph), ctypes.c_int, ctypes.c_int]
+lib.bidirectional_a_star_shortest_path.restype = PathResult
+
+# PathResult find_shortest_path(const Graph* graph, SearchAlgorithm algorithm, int start_id, int end_id);
+lib.find_shortest_path.argtypes = [ctypes.POINTER(Graph), ctypes.c_int, ctypes.c_int, ctypes.c_int]
+lib.find_shortest_path.restype = PathResult
+
+# const char* search_algorithm_name(SearchAlgorithm algorithm);
+lib.search_algorithm_name.argtypes = [ctypes.c_int]
+lib.search_algorithm_name.restype = ctypes.c_char_p
+
+# ContractionHierarchy* ch_build(const Graph* graph);  (opaque to Python)
+lib.ch_build.argtypes = [ctypes.POINTER(Graph)]
+lib.ch_build.restype = ctypes.c_void_p
+
+# void ch_destroy(ContractionHierarchy* ch);
+lib.ch_destroy.argtypes = [ctypes.c_void_p]
+
+# PathResult ch_shortest_path(const ContractionHierarchy* ch, int start_id, int end_id);
+lib.ch_shortest_path.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+lib.ch_shortest_path.restype = PathResult
+
+# LandmarkSet* landmarks_build(const Graph* graph, int count, LandmarkSelection selection);  (opaque to Python)
+lib.landmarks_build.argtypes = [ctypes.POINTER(Graph), ctypes.c_int, ctypes.c_int]
+lib.landmarks_build.restype = ctypes.c_void_p
+
+# LandmarkSet* landmarks_load(const Graph* graph, const char* filename);
+lib.landmarks_load.argtypes = [ctypes.POINTER(Graph), ctypes.c_char_p]
+lib.landmarks_load.restype = ctypes.c_void_p
+
+# bool landmarks_save(const LandmarkSet* landmarks, const char* filename);
+lib.landmarks_save.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+lib.landmarks_save.restype = ctypes.c_bool
+
+# void landmarks_destroy(LandmarkSet* landmarks);
+lib.landmarks_destroy.argtypes = [ctypes.c_void_p]
+
+# PathResult alt_shortest_path(const Graph* graph, const LandmarkSet* landmarks, int start_id, int end_id);
+lib.alt_shortest_path.argtypes = [ctypes.POINTER(Graph), ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+lib.alt_shortest_path.restype = PathResult
+
+# DistanceMatrix* apsp_load_or_build(const Graph* graph, const char* map_filename, int num_threads);  (opaque to Python)
+lib.apsp_load_or_build.argtypes = [ctypes.POINTER(Graph), ctypes.c_char_p, ctypes.c_int]
+lib.apsp_load_or_build.restype = ctypes.c_void_p
+
+# void apsp_destroy(DistanceMatrix* matrix);
+lib.apsp_destroy.argtypes = [ctypes.c_void_p]
+
+# double apsp_distance(const DistanceMatrix* matrix, int start_id, int end_id);
+lib.apsp_distance.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+lib.apsp_distance.restype = ctypes.c_double
+
+# PathResult apsp_shortest_path(const DistanceMatrix* matrix, const Graph* graph, int start_id, int end_id);
+lib.apsp_shortest_path.argtypes = [ctypes.c_void_p, ctypes.POINTER(Graph), ctypes.c_int, ctypes.c_int]
+lib.apsp_shortest_path.restype = PathResult
+
+# bool batch_shortest_paths(const Graph* graph, const RoutePair* pairs, int num_pairs,
+#                           SearchAlgorithm algorithm, PathResult* results, int num_threads);
+lib.batch_shortest_paths.argtypes = [ctypes.POINTER(Graph), ctypes.POINTER(RoutePair), ctypes.c_int,
+                                     ctypes.c_int, ctypes.POINTER(PathResult), ctypes.c_int]
+lib.batch_shortest_paths.restype = ctypes.c_bool
+
+# void batch_free_results(PathResult* results, int num_results);
+lib.batch_free_results.argtypes = [ctypes.POINTER(PathResult), ctypes.c_int]
+
+# bool distance_table_fill(const Graph* graph, const int* sources, int num_sources,
+#                          const int* targets, int num_targets, double* distances, int* predecessors);
+lib.distance_table_fill.argtypes = [ctypes.POINTER(Graph), ctypes.POINTER(ctypes.c_int), ctypes.c_int,
+                                    ctypes.POINTER(ctypes.c_int), ctypes.c_int,
+                                    ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_int)]
+lib.distance_table_fill.restype = ctypes.c_bool
+
+# SearchWorkspace* search_workspace_create(int capacity);  (opaque to Python)
+lib.search_workspace_create.argtypes = [ctypes.c_int]
+lib.search_workspace_create.restype = ctypes.c_void_p
+
+# void search_workspace_destroy(SearchWorkspace* workspace);
+lib.search_workspace_destroy.argtypes = [ctypes.c_void_p]
+
+# PathResult dijkstra_shortest_path_ws(const Graph* graph, SearchWorkspace* workspace, int start_id, int end_id);
+lib.dijkstra_shortest_path_ws.argtypes = [ctypes.POINTER(Graph), ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+lib.dijkstra_shortest_path_ws.restype = PathResult
+
+# PathResult a_star_shortest_path_ws(const Graph* graph, SearchWorkspace* workspace, int start_id, int end_id);
+lib.a_star_shortest_path_ws.argtypes = [ctypes.POINTER(Graph), ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+lib.a_star_shortest_path_ws.restype = PathResult
+
 # void free_path_result(PathResult* result);
 lib.free_path_result.argtypes = [ctypes.POINTER(PathResult)]
 
+# uint64_t graph_version(const Graph* graph);
+lib.graph_version.argtypes = [ctypes.POINTER(Graph)]
+lib.graph_version.restype = ctypes.c_uint64
+
+# bool graph_set_edge_weight(Graph* graph, int source_id, int destination_id, double weight);
+lib.graph_set_edge_weight.argtypes = [ctypes.POINTER(Graph), ctypes.c_int, ctypes.c_int, ctypes.c_double]
+lib.graph_set_edge_weight.restype = ctypes.c_bool
+
+# bool graph_close_edge(Graph* graph, int source_id, int destination_id);
+lib.graph_close_edge.argtypes = [ctypes.POINTER(Graph), ctypes.c_int, ctypes.c_int]
+lib.graph_close_edge.restype = ctypes.c_bool
+
+# bool graph_open_edge(Graph* graph, int source_id, int destination_id);
+lib.graph_open_edge.argtypes = [ctypes.POINTER(Graph), ctypes.c_int, ctypes.c_int]
+lib.graph_open_edge.restype = ctypes.c_bool
+
+# bool graph_is_edge_closed(const Graph* graph, int source_id, int destination_id);
+lib.graph_is_edge_closed.argtypes = [ctypes.POINTER(Graph), ctypes.c_int, ctypes.c_int]
+lib.graph_is_edge_closed.restype = ctypes.c_bool
+
+# int graph_apply_updates(Graph* graph, const GraphUpdate* updates, int num_updates);
+lib.graph_apply_updates.argtypes = [ctypes.POINTER(Graph), ctypes.POINTER(GraphUpdate), ctypes.c_int]
+lib.graph_apply_updates.restype = ctypes.c_int
+
+# int graph_changes_since(const Graph* graph, uint64_t version, const GraphChange** changes);
+lib.graph_changes_since.argtypes = [ctypes.POINTER(Graph), ctypes.c_uint64, ctypes.POINTER(ctypes.POINTER(GraphChange))]
+lib.graph_changes_since.restype = ctypes.c_int
+
+# int dijkstra_repair_tree_ws(const Graph* graph, SearchWorkspace* workspace, int source_id, double* distances,
+#                             int* predecessors, const GraphChange* changes, int num_changes);
+lib.dijkstra_repair_tree_ws.argtypes = [ctypes.POINTER(Graph), ctypes.c_void_p, ctypes.c_int,
+                                        ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_int),
+                                        ctypes.POINTER(GraphChange), ctypes.c_int]
+lib.dijkstra_repair_tree_ws.restype = ctypes.c_int
+
+# RouteCache* route_cache_create(const Graph* graph, int capacity);  (opaque to Python)
+lib.route_cache_create.argtypes = [ctypes.POINTER(Graph), ctypes.c_int]
+lib.route_cache_create.restype = ctypes.c_void_p
+
+# void route_cache_destroy(RouteCache* cache);
+lib.route_cache_destroy.argtypes = [ctypes.c_void_p]
+
+# void route_cache_clear(RouteCache* cache);
+lib.route_cache_clear.argtypes = [ctypes.c_void_p]
+
+# const SharedRoute* route_cache_get(RouteCache* cache, SearchWorkspace* workspace, SearchAlgorithm algorithm,
+#                                    int start_id, int end_id);
+lib.route_cache_get.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+lib.route_cache_get.restype = ctypes.POINTER(SharedRoute)
+
+# void route_cache_release(const SharedRoute* route);
+lib.route_cache_release.argtypes = [ctypes.POINTER(SharedRoute)]
+
+# RouteCacheStats route_cache_stats(RouteCache* cache);
+lib.route_cache_stats.argtypes = [ctypes.c_void_p]
+lib.route_cache_stats.restype = RouteCacheStats
+
+# SpatialIndex* spatial_index_build(const Graph* graph);  (opaque to Python)
+lib.spatial_index_build.argtypes = [ctypes.POINTER(Graph)]
+lib.spatial_index_build.restype = ctypes.c_void_p
+
+# void spatial_index_destroy(SpatialIndex* index);
+lib.spatial_index_destroy.argtypes = [ctypes.c_void_p]
+
+# int spatial_nearest(const SpatialIndex* index, double latitude, double longitude, double* distance_km);
+lib.spatial_nearest.argtypes = [ctypes.c_void_p, ctypes.c_double, ctypes.c_double, ctypes.POINTER(ctypes.c_double)]
+lib.spatial_nearest.restype = ctypes.c_int
+
+# NameIndex* name_index_build(const Graph* graph);  (opaque to Python)
+lib.name_index_build.argtypes = [ctypes.POINTER(Graph)]
+lib.name_index_build.restype = ctypes.c_void_p
+
+# void name_index_destroy(NameIndex* index);
+lib.name_index_destroy.argtypes = [ctypes.c_void_p]
+
+# int name_index_find(const NameIndex* index, const char* name);
+lib.name_index_find.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+lib.name_index_find.restype = ctypes.c_int
+
+# int name_index_complete(const NameIndex* index, const char* prefix, int max_results, int* node_ids);
+lib.name_index_complete.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_int, ctypes.POINTER(ctypes.c_int)]
+lib.name_index_complete.restype = ctypes.c_int
+
+# ShortestPathTree* shortest_path_tree(const Graph* graph, int source_id);
+lib.shortest_path_tree.argtypes = [ctypes.POINTER(Graph), ctypes.c_int]
+lib.shortest_path_tree.restype = ctypes.POINTER(ShortestPathTree)
+
+# ShortestPathTree* shortest_path_tree_ws(const Graph* graph, SearchWorkspace* workspace, int source_id);
+lib.shortest_path_tree_ws.argtypes = [ctypes.POINTER(Graph), ctypes.c_void_p, ctypes.c_int]
+lib.shortest_path_tree_ws.restype = ctypes.POINTER(ShortestPathTree)
+
+# void shortest_path_tree_destroy(ShortestPathTree* tree);
+lib.shortest_path_tree_destroy.argtypes = [ctypes.POINTER(ShortestPathTree)]
+
+# bool shortest_path_tree_update(ShortestPathTree* tree, const Graph* graph, SearchWorkspace* workspace);
+lib.shortest_path_tree_update.argtypes = [ctypes.POINTER(ShortestPathTree), ctypes.POINTER(Graph), ctypes.c_void_p]
+lib.shortest_path_tree_update.restype = ctypes.c_bool
+
+# double shortest_path_tree_distance(const ShortestPathTree* tree, int target_id);
+lib.shortest_path_tree_distance.argtypes = [ctypes.POINTER(ShortestPathTree), ctypes.c_int]
+lib.shortest_path_tree_distance.restype = ctypes.c_double
+
+# PathResult shortest_path_tree_path(const ShortestPathTree* tree, int target_id);
+lib.shortest_path_tree_path.argtypes = [ctypes.POINTER(ShortestPathTree), ctypes.c_int]
+lib.shortest_path_tree_path.restype = PathResult
+
+# double shortest_path_tree_max_distance(const ShortestPathTree* tree);
+lib.shortest_path_tree_max_distance.argtypes = [ctypes.POINTER(ShortestPathTree)]
+lib.shortest_path_tree_max_distance.restype = ctypes.c_double
+
+# int k_shortest_paths(const Graph* graph, int start_id, int end_id, int k, PathResult* results);
+lib.k_shortest_paths.argtypes = [ctypes.POINTER(Graph), ctypes.c_int, ctypes.c_int, ctypes.c_int,
+                                 ctypes.POINTER(PathResult)]
+lib.k_shortest_paths.restype = ctypes.c_int
+
+# int k_shortest_paths_ws(const Graph* graph, SearchWorkspace* workspace, int start_id, int end_id, int k,
+#                         PathResult* results);
+lib.k_shortest_paths_ws.argtypes = [ctypes.POINTER(Graph), ctypes.c_void_p, ctypes.c_int, ctypes.c_int, ctypes.c_int,
+                                    ctypes.POINTER(PathResult)]
+lib.k_shortest_paths_ws.restype = ctypes.c_int
+
+# TimeProfiles* time_profiles_load(const Graph* graph, const char* filename);
+lib.time_profiles_load.argtypes = [ctypes.POINTER(Graph), ctypes.c_char_p]
+lib.time_profiles_load.restype = ctypes.POINTER(TimeProfiles)
+
+# void time_profiles_destroy(TimeProfiles* profiles);
+lib.time_profiles_destroy.argtypes = [ctypes.POINTER(TimeProfiles)]
+
+# double time_profiles_arrival(const TimeProfiles* profiles, const Graph* graph, int edge_index, double departure_time);
+lib.time_profiles_arrival.argtypes = [ctypes.POINTER(TimeProfiles), ctypes.POINTER(Graph), ctypes.c_int, ctypes.c_double]
+lib.time_profiles_arrival.restype = ctypes.c_double
+
+# PathResult td_dijkstra_shortest_path(const Graph* graph, const TimeProfiles* profiles, int start_id, int end_id,
+#                                      double departure_time, double* arrival_time);
+lib.td_dijkstra_shortest_path.argtypes = [ctypes.POINTER(Graph), ctypes.POINTER(TimeProfiles), ctypes.c_int,
+                                          ctypes.c_int, ctypes.c_double, ctypes.POINTER(ctypes.c_double)]
+lib.td_dijkstra_shortest_path.restype = PathResult
+
+# PathResult td_a_star_shortest_path(const Graph* graph, const TimeProfiles* profiles, int start_id, int end_id,
+#                                    double departure_time, double* arrival_time);
+lib.td_a_star_shortest_path.argtypes = [ctypes.POINTER(Graph), ctypes.POINTER(TimeProfiles), ctypes.c_int,
+                                        ctypes.c_int, ctypes.c_double, ctypes.POINTER(ctypes.c_double)]
+lib.td_a_star_shortest_path.restype = PathResult
+
+# PathResult td_a_star_shortest_path_ws(const Graph* graph, const TimeProfiles* profiles, SearchWorkspace* workspace,
+#                                       int start_id, int end_id, double departure_time, double* arrival_time);
+lib.td_a_star_shortest_path_ws.argtypes = [ctypes.POINTER(Graph), ctypes.POINTER(TimeProfiles), ctypes.c_void_p,
+                                           ctypes.c_int, ctypes.c_int, ctypes.c_double,
+                                           ctypes.POINTER(ctypes.c_double)]
+lib.td_a_star_shortest_path_ws.restype = PathResult
+
+# Isochrone* isochrone(const Graph* graph, int source_id, double max_distance, bool with_outline);
+lib.isochrone.argtypes = [ctypes.POINTER(Graph), ctypes.c_int, ctypes.c_double, ctypes.c_bool]
+lib.isochrone.restype = ctypes.POINTER(Isochrone)
+
+# Isochrone* isochrone_ws(const Graph* graph, SearchWorkspace* workspace, int source_id, double max_distance,
+#                         bool with_outline);
+lib.isochrone_ws.argtypes = [ctypes.POINTER(Graph), ctypes.c_void_p, ctypes.c_int, ctypes.c_double, ctypes.c_bool]
+lib.isochrone_ws.restype = ctypes.POINTER(Isochrone)
+
+# void isochrone_destroy(Isochrone* area);
+lib.isochrone_destroy.argtypes = [ctypes.POINTER(Isochrone)]
+
+# Fills a sources x targets distance table in one C call. Returns flat row-major
+# buffers (distances[s * len(targets) + t], predecessors[s * node_count + v]),
+# or None if the table could not be built.
+def distance_table(graph, sources, targets, with_predecessors=False):
+    source_buf = (ctypes.c_int * len(sources))(*sources)
+    target_buf = (ctypes.c_int * len(targets))(*targets)
+    distances = (ctypes.c_double * (len(sources) * len(targets)))()
+    predecessors = None
+    if with_predecessors:
+        predecessors = (ctypes.c_int * (len(sources) * lib.get_node_count(graph)))()
+    if not lib.distance_table_fill(graph, source_buf, len(sources), target_buf, len(targets),
+                                   distances, predecessors):
+        return None
+    return distances, predecessors
+
+# Node IDs whose names start with prefix (case-insensitive), in name order.
+def complete_name(names, prefix, max_results=10):
+    node_ids = (ctypes.c_int * max_results)()
+    count = lib.name_index_complete(names, prefix.encode('utf-8'), max_results, node_ids)
+    return list(node_ids[:max(count, 0)])
+
+# Zero-copy views of a tree's (distances, predecessors, order) arrays. They share
+# the tree's single buffer, support the buffer protocol (memoryview,
+# numpy.frombuffer) and are valid until shortest_path_tree_destroy().
+def tree_arrays(tree):
+    t = tree.contents
+    distances = ctypes.cast(t.distances, ctypes.POINTER(ctypes.c_double * t.num_nodes)).contents
+    predecessors = ctypes.cast(t.predecessors, ctypes.POINTER(ctypes.c_int * t.num_nodes)).contents
+    order = ctypes.cast(t.order, ctypes.POINTER(ctypes.c_int * t.num_reached)).contents
+    return distances, predecessors, order
+
+# Up to k loopless routes, shortest first, as (distance_km, [node ids]) tuples.
+def k_shortest_paths(graph, start_id, end_id, k):
+    results = (PathResult * k)()
+    found = lib.k_shortest_paths(graph, start_id, end_id, k, results)
+    routes = [(r.total_distance, r.path[:r.path_length]) for r in results[:max(found, 0)]]
+    lib.batch_free_results(results, k)
+    return routes
+
+# Earliest-arrival route leaving at departure_time (seconds since midnight), as
+# (arrival_seconds, distance_km, [node ids]), or None if there is no route.
+def time_dependent_route(graph, profiles, start_id, end_id, departure_time):
+    arrival = ctypes.c_double()
+    result = lib.td_a_star_shortest_path(graph, profiles, start_id, end_id, departure_time, ctypes.byref(arrival))
+    route = (arrival.value, result.total_distance, result.path[:result.path_length]) if result.found else None
+    lib.free_path_result(ctypes.byref(result))
+    return route
+
+# Everything within max_km of source_id, as ([(node_id, distance_km)] nearest
+# first, [(lat, lon)] outline), or None on error. The outline is empty unless
+# with_outline is set.
+def reachable_within(graph, source_id, max_km, with_outline=True):
+    area = lib.isochrone(graph, source_id, max_km, with_outline)
+    if not area:
+        return None
+    a = area.contents
+    reached = [(r.node_id, r.distance) for r in a.reached[:a.num_reached]]
+    outline = [(a.outline[2 * i], a.outline[2 * i + 1]) for i in range(a.num_outline)]
+    lib.isochrone_destroy(area)
+    return reached, outline
+
+# Applies a list of (kind, source_id, destination_id, weight) updates in one C call;
+# returns how many succeeded.
+def apply_updates(graph, updates):
+    buf = (GraphUpdate * len(updates))(*[GraphUpdate(k, u, v, w) for k, u, v, w in updates])
+    return lib.graph_apply_updates(graph, buf, len(updates))
+
 # Helper to get string from char array
 def decode_str(char_arr):
     return char_arr.decode('utf-8')
\ No newline at end of file
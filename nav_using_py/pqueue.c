@@ -0,0 +1,129 @@
+/*
+ * Indexed Binary Min-Heap Implementation
+ *
+ * The position map is never reset: a node is queued only if its recorded slot
+ * is inside the heap and that slot points back at it. Clearing is O(1).
+ */
+
+ #include "pqueue.h"
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+
+ bool heap_init(IndexedHeap* heap, int capacity) {
+     heap->entries = NULL;
+     heap->position = NULL;
+     heap->size = 0;
+     heap->capacity = 0;
+     return heap_reserve(heap, capacity);
+ }
+
+ bool heap_reserve(IndexedHeap* heap, int capacity) {
+     if (capacity <= heap->capacity) return true;
+
+     HeapEntry* entries = realloc(heap->entries, capacity * sizeof(HeapEntry));
+     if (!entries) {
+         fprintf(stderr, "[Heap Error] heap_reserve: Failed to allocate %d entries\n", capacity);
+         return false;
+     }
+     heap->entries = entries;
+
+     int* position = realloc(heap->position, capacity * sizeof(int));
+     if (!position) {
+         fprintf(stderr, "[Heap Error] heap_reserve: Failed to allocate position map\n");
+         return false;
+     }
+     memset(position + heap->capacity, 0, (capacity - heap->capacity) * sizeof(int));
+     heap->position = position;
+     heap->capacity = capacity;
+     return true;
+ }
+
+ void heap_free(IndexedHeap* heap) {
+     free(heap->entries);
+     free(heap->position);
+     heap->entries = NULL;
+     heap->position = NULL;
+     heap->size = 0;
+     heap->capacity = 0;
+ }
+
+ void heap_clear(IndexedHeap* heap) {
+     heap->size = 0;
+ }
+
+ bool heap_contains(const IndexedHeap* heap, int node_id) {
+     int slot = heap->position[node_id];
+     return slot < heap->size && heap->entries[slot].node_id == node_id;
+ }
+
+ static void sift_up(IndexedHeap* heap, int slot) {
+     HeapEntry moving = heap->entries[slot];
+     while (slot > 0) {
+         int parent = (slot - 1) / 2;
+         if (heap->entries[parent].key <= moving.key) break;
+         heap->entries[slot] = heap->entries[parent];
+         heap->position[heap->entries[slot].node_id] = slot;
+         slot = parent;
+     }
+     heap->entries[slot] = moving;
+     heap->position[moving.node_id] = slot;
+ }
+
+ static void sift_down(IndexedHeap* heap, int slot) {
+     HeapEntry moving = heap->entries[slot];
+     int half = heap->size / 2;
+     while (slot < half) {
+         int child = 2 * slot + 1;
+         if (child + 1 < heap->size && heap->entries[child + 1].key < heap->entries[child].key) child++;
+         if (moving.key <= heap->entries[child].key) break;
+         heap->entries[slot] = heap->entries[child];
+         heap->position[heap->entries[slot].node_id] = slot;
+         slot = child;
+     }
+     heap->entries[slot] = moving;
+     heap->position[moving.node_id] = slot;
+ }
+
+ // Inserts node_id, or lowers its key if it is already queued with a larger one
+ void heap_push_or_decrease(IndexedHeap* heap, int node_id, double key) {
+     if (heap_contains(heap, node_id)) {
+         int slot = heap->position[node_id];
+         if (key < heap->entries[slot].key) {
+             heap->entries[slot].key = key;
+             sift_up(heap, slot);
+         }
+         return;
+     }
+     int slot = heap->size++;
+     heap->entries[slot].key = key;
+     heap->entries[slot].node_id = node_id;
+     sift_up(heap, slot);
+ }
+
+ // Inserts node_id or moves it to the new key in either direction
+ void heap_update(IndexedHeap* heap, int node_id, double key) {
+     if (!heap_contains(heap, node_id)) {
+         heap_push_or_decrease(heap, node_id, key);
+         return;
+     }
+     int slot = heap->position[node_id];
+     double old_key = heap->entries[slot].key;
+     heap->entries[slot].key = key;
+     if (key < old_key) sift_up(heap, slot);
+     else sift_down(heap, slot);
+ }
+ 
+ int heap_pop_min(IndexedHeap* heap, double* key) {
+     if (heap->size == 0) return -1;
+     HeapEntry top = heap->entries[0];
+     heap->size--;
+     if (heap->size > 0) {
+         heap->entries[0] = heap->entries[heap->size];
+         sift_down(heap, 0);
+     }
+     // Point the popped node past the end so heap_contains() rejects it
+     heap->position[top.node_id] = heap->capacity;
+     if (key) *key = top.key;
+     return top.node_id;
+ }
@@ -0,0 +1,37 @@
+/*
+ * Indexed Binary Min-Heap - Priority queue keyed by node id.
+ */
+
+ #ifndef PQUEUE_H
+ #define PQUEUE_H
+
+ #include <stdbool.h>
+
+ typedef struct {
+     double key;
+     int node_id;
+ } HeapEntry;
+
+ typedef struct {
+     HeapEntry* entries;   // Array-backed binary heap
+     int* position;        // node_id -> slot in entries (valid only while queued)
+     int size;
+     int capacity;         // Number of node ids the heap can index
+ } IndexedHeap;
+
+ // Lifecycle Management
+ bool heap_init(IndexedHeap* heap, int capacity);
+ bool heap_reserve(IndexedHeap* heap, int capacity);
+ void heap_free(IndexedHeap* heap);
+ void heap_clear(IndexedHeap* heap);
+
+ // Operations
+ bool heap_contains(const IndexedHeap* heap, int node_id);
+ void heap_push_or_decrease(IndexedHeap* heap, int node_id, double key);
+ void heap_update(IndexedHeap* heap, int node_id, double key);
+ int heap_pop_min(IndexedHeap* heap, double* key);
+
+ static inline bool heap_is_empty(const IndexedHeap* heap) { return heap->size == 0; }
+ static inline double heap_min_key(const IndexedHeap* heap) { return heap->entries[0].key; }
+
+ #endif // PQUEUE_H
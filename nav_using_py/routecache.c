@@ -0,0 +1,294 @@
+/*
+ * Route Cache Implementation
+ *
+ * Entries live in a fixed array sized at creation. Each is on one hash chain
+ * (for lookup) and on a doubly linked recency list (for eviction), both
+ * linked by array index. Searches run outside the lock, so a miss never
+ * stalls hits on other threads; if two threads miss on the same route, the
+ * first to finish is cached and the other's result is simply returned.
+ *
+ * When the graph changes, the graph's change log (graph_changes_since) tells
+ * which routes a closure or weight change can touch; only those are dropped.
+ */
+
+ #include "routecache.h"
+ #include "utils.h"
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <math.h>
+
+ struct RouteCacheEntry {
+     int start_id;
+     int end_id;
+     SearchAlgorithm algorithm;
+     SharedRoute* route;
+     int hash_next;
+     int prev;                // Towards lru_head
+     int next;                // Towards lru_tail; also links the free list
+ };
+
+ static uint32_t hash_key(int start_id, int end_id, SearchAlgorithm algorithm) {
+     uint64_t key = ((uint64_t)(uint32_t)start_id << 32) | (uint32_t)end_id;
+     key ^= (uint64_t)algorithm * 0x9E3779B97F4A7C15ULL;
+     key ^= key >> 33;
+     key *= 0xFF51AFD7ED558CCDULL;
+     key ^= key >> 33;
+     return (uint32_t)key;
+ }
+
+ RouteCache* route_cache_create(const Graph* graph, int capacity) {
+     if (!graph || capacity <= 0) {
+         fprintf(stderr, "[RouteCache Error] route_cache_create: Graph is NULL or capacity %d is not positive\n", capacity);
+         return NULL;
+     }
+     int buckets = 16;
+     while (buckets < 2 * capacity && buckets < (1 << 30)) buckets *= 2;
+
+     RouteCache* cache = calloc(1, sizeof(RouteCache));
+     if (!cache) {
+         fprintf(stderr, "[RouteCache Error] route_cache_create: Failed to allocate cache\n");
+         return NULL;
+     }
+     cache->entries = malloc((size_t)capacity * sizeof(RouteCacheEntry));
+     cache->buckets = malloc((size_t)buckets * sizeof(int));
+     if (!cache->entries || !cache->buckets || pthread_mutex_init(&cache->lock, NULL) != 0) {
+         fprintf(stderr, "[RouteCache Error] route_cache_create: Failed to allocate %d entries\n", capacity);
+         free(cache->entries);
+         free(cache->buckets);
+         free(cache);
+         return NULL;
+     }
+     cache->graph = graph;
+     cache->capacity = capacity;
+     cache->bucket_mask = buckets - 1;
+     cache->stats.capacity = capacity;
+     cache->size = 0;
+     cache->lru_head = cache->lru_tail = -1;
+     for (int i = 0; i < buckets; i++) cache->buckets[i] = -1;
+     for (int i = 0; i < capacity; i++) cache->entries[i].next = i + 1 < capacity ? i + 1 : -1;
+     cache->free_head = 0;
+     cache->graph_version = graph_version(graph);
+     return cache;
+ }
+
+ void route_cache_release(const SharedRoute* route) {
+     if (!route) return;
+     SharedRoute* shared = (SharedRoute*)route;
+     if (atomic_fetch_sub(&shared->refcount, 1) == 1) {
+         free_path_result(&shared->result);
+         free(shared);
+     }
+ }
+
+ // Locked helpers
+
+ static void unlink_lru(RouteCache* cache, int index) {
+     RouteCacheEntry* entry = &cache->entries[index];
+     if (entry->prev != -1) cache->entries[entry->prev].next = entry->next;
+     else cache->lru_head = entry->next;
+     if (entry->next != -1) cache->entries[entry->next].prev = entry->prev;
+     else cache->lru_tail = entry->prev;
+ }
+
+ static void push_front(RouteCache* cache, int index) {
+     RouteCacheEntry* entry = &cache->entries[index];
+     entry->prev = -1;
+     entry->next = cache->lru_head;
+     if (cache->lru_head != -1) cache->entries[cache->lru_head].prev = index;
+     cache->lru_head = index;
+     if (cache->lru_tail == -1) cache->lru_tail = index;
+ }
+
+ static int find_entry(const RouteCache* cache, int start_id, int end_id, SearchAlgorithm algorithm) {
+     int index = cache->buckets[hash_key(start_id, end_id, algorithm) & (uint32_t)cache->bucket_mask];
+     while (index != -1) {
+         const RouteCacheEntry* entry = &cache->entries[index];
+         if (entry->start_id == start_id && entry->end_id == end_id && entry->algorithm == algorithm) return index;
+         index = entry->hash_next;
+     }
+     return -1;
+ }
+
+ // Unlinks an entry from its chain and the recency list, drops the cache's
+ // reference and returns the slot to the free list
+ static void remove_entry(RouteCache* cache, int index) {
+     RouteCacheEntry* entry = &cache->entries[index];
+     int* link = &cache->buckets[hash_key(entry->start_id, entry->end_id, entry->algorithm) & (uint32_t)cache->bucket_mask];
+     while (*link != index) link = &cache->entries[*link].hash_next;
+     *link = entry->hash_next;
+     unlink_lru(cache, index);
+
+     route_cache_release(entry->route);
+     entry->route = NULL;
+     entry->next = cache->free_head;
+     cache->free_head = index;
+     cache->size--;
+ }
+
+ static void remove_all(RouteCache* cache) {
+     while (cache->lru_head != -1) remove_entry(cache, cache->lru_head);
+ }
+
+ // Great-circle lower bound on any path between two nodes, from their unit vectors
+ static double straight_line_km(const Graph* graph, int a, int b) {
+     const double* p = &graph->unit_vectors[3 * a];
+     const double* q = &graph->unit_vectors[3 * b];
+     double dx = p[0] - q[0], dy = p[1] - q[1], dz = p[2] - q[2];
+     return EARTH_RADIUS_KM * sqrt(dx * dx + dy * dy + dz * dz);
+ }
+
+ // Whether a weight change can alter a cached route. A slower edge only
+ // matters to routes that use it. A faster edge matters if a path through it
+ // could undercut the route, judged with the same straight-line bound A* uses.
+ static bool route_affected(const Graph* graph, const RouteCacheEntry* entry, const GraphChange* change) {
+     const PathResult* result = &entry->route->result;
+     int u = change->source_id;
+     int v = change->destination_id;
+     if (change->new_weight > change->old_weight) {
+         for (int i = 0; i + 1 < result->path_length; i++) {
+             if (result->path[i] == u && result->path[i + 1] == v) return true;
+         }
+         return false;
+     }
+     if (!result->found) return true;
+     double bound = straight_line_km(graph, entry->start_id, u) + change->new_weight
+                    + straight_line_km(graph, v, entry->end_id);
+     return bound < result->total_distance;
+ }
+
+ // Brings the cache up to the graph's version: with a change log covering the
+ // gap only the routes a change can affect are dropped, otherwise all of them
+ static void check_version(RouteCache* cache) {
+     uint64_t version = graph_version(cache->graph);
+     if (version == cache->graph_version) return;
+
+     const GraphChange* changes;
+     int num_changes = graph_changes_since(cache->graph, cache->graph_version, &changes);
+     for (int c = 0; c < num_changes; c++) {
+         // An edge made shorter than the straight line breaks the bound above
+         const GraphChange* change = &changes[c];
+         if (change->new_weight < straight_line_km(cache->graph, change->source_id, change->destination_id)) {
+             num_changes = -1;
+             break;
+         }
+     }
+     if (num_changes < 0) {
+         cache->stats.invalidations += (uint64_t)cache->size;
+         remove_all(cache);
+     } else {
+         for (int index = cache->lru_head; index != -1;) {
+             int next = cache->entries[index].next;
+             for (int c = 0; c < num_changes; c++) {
+                 if (route_affected(cache->graph, &cache->entries[index], &changes[c])) {
+                     remove_entry(cache, index);
+                     cache->stats.invalidations++;
+                     break;
+                 }
+             }
+             index = next;
+         }
+     }
+     cache->graph_version = version;
+ }
+
+ static void insert_entry(RouteCache* cache, int start_id, int end_id, SearchAlgorithm algorithm, SharedRoute* route) {
+     if (cache->free_head == -1) {
+         remove_entry(cache, cache->lru_tail);
+         cache->stats.evictions++;
+     }
+     int index = cache->free_head;
+     RouteCacheEntry* entry = &cache->entries[index];
+     cache->free_head = entry->next;
+
+     entry->start_id = start_id;
+     entry->end_id = end_id;
+     entry->algorithm = algorithm;
+     entry->route = route;
+     atomic_fetch_add(&route->refcount, 1);
+     uint32_t bucket = hash_key(start_id, end_id, algorithm) & (uint32_t)cache->bucket_mask;
+     entry->hash_next = cache->buckets[bucket];
+     cache->buckets[bucket] = index;
+     push_front(cache, index);
+     cache->size++;
+ }
+
+ const SharedRoute* route_cache_get(RouteCache* cache, SearchWorkspace* workspace, SearchAlgorithm algorithm,
+                                    int start_id, int end_id) {
+     if (!cache) {
+         fprintf(stderr, "[RouteCache Error] route_cache_get: Cache is NULL\n");
+         return NULL;
+     }
+
+     pthread_mutex_lock(&cache->lock);
+     check_version(cache);
+     int index = find_entry(cache, start_id, end_id, algorithm);
+     if (index != -1) {
+         SharedRoute* route = cache->entries[index].route;
+         atomic_fetch_add(&route->refcount, 1);
+         unlink_lru(cache, index);
+         push_front(cache, index);
+         cache->stats.hits++;
+         pthread_mutex_unlock(&cache->lock);
+         return route;
+     }
+     cache->stats.misses++;
+     uint64_t version = cache->graph_version;
+     pthread_mutex_unlock(&cache->lock);
+
+     SharedRoute* route = malloc(sizeof(SharedRoute));
+     if (!route) {
+         fprintf(stderr, "[RouteCache Error] route_cache_get: Failed to allocate route\n");
+         return NULL;
+     }
+     route->result = workspace ? find_shortest_path_ws(cache->graph, workspace, algorithm, start_id, end_id)
+                               : find_shortest_path(cache->graph, algorithm, start_id, end_id);
+     atomic_init(&route->refcount, 1);
+
+     // A path in the workspace's caller-owned buffer would be overwritten by the next query
+     if (route->result.found && !route->result.owns_path) {
+         int* path = malloc((size_t)route->result.path_length * sizeof(int));
+         if (!path) {
+             fprintf(stderr, "[RouteCache Error] route_cache_get: Failed to copy path\n");
+             free(route);
+             return NULL;
+         }
+         memcpy(path, route->result.path, (size_t)route->result.path_length * sizeof(int));
+         route->result.path = path;
+         route->result.owns_path = true;
+     }
+
+     pthread_mutex_lock(&cache->lock);
+     check_version(cache);
+     if (cache->graph_version == version && find_entry(cache, start_id, end_id, algorithm) == -1) {
+         insert_entry(cache, start_id, end_id, algorithm, route);
+     }
+     pthread_mutex_unlock(&cache->lock);
+     return route;
+ }
+
+ void route_cache_clear(RouteCache* cache) {
+     if (!cache) return;
+     pthread_mutex_lock(&cache->lock);
+     remove_all(cache);
+     pthread_mutex_unlock(&cache->lock);
+ }
+
+ RouteCacheStats route_cache_stats(RouteCache* cache) {
+     RouteCacheStats stats = { 0 };
+     if (!cache) return stats;
+     pthread_mutex_lock(&cache->lock);
+     stats = cache->stats;
+     stats.size = cache->size;
+     pthread_mutex_unlock(&cache->lock);
+     return stats;
+ }
+
+ void route_cache_destroy(RouteCache* cache) {
+     if (!cache) return;
+     remove_all(cache);
+     pthread_mutex_destroy(&cache->lock);
+     free(cache->entries);
+     free(cache->buckets);
+     free(cache);
+ }
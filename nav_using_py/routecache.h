@@ -0,0 +1,69 @@
+/*
+ * Route Cache - Bounded LRU cache of shortest path results.
+ */
+
+ #ifndef ROUTECACHE_H
+ #define ROUTECACHE_H
+
+ #include "graph.h"
+ #include "algorithms.h"
+ #include <pthread.h>
+ #include <stdatomic.h>
+ #include <stdint.h>
+
+ // An immutable result shared by the cache and every caller holding it. The
+ // path stays valid until the holder calls route_cache_release(), even if
+ // the cache evicts or invalidates the route in the meantime.
+ typedef struct {
+     PathResult result;
+     atomic_int refcount;     // Holders, counting the cache itself while it keeps the route
+ } SharedRoute;
+
+ typedef struct {
+     uint64_t hits;
+     uint64_t misses;
+     uint64_t evictions;      // Routes dropped to make room
+     uint64_t invalidations;  // Routes dropped because the graph changed under them
+     int size;
+     int capacity;
+ } RouteCacheStats;
+
+ typedef struct RouteCacheEntry RouteCacheEntry;
+
+ typedef struct {
+     const Graph* graph;
+     uint64_t graph_version;  // Version the cached routes were computed on
+
+     int capacity;
+     int size;
+     RouteCacheEntry* entries;
+     int free_head;           // Unused entries, linked through next
+     int lru_head;            // Most recently used
+     int lru_tail;            // Evicted first
+
+     int* buckets;            // Hash chains of entry indices, -1 terminated
+     int bucket_mask;
+
+     RouteCacheStats stats;
+     pthread_mutex_t lock;
+ } RouteCache;
+
+ // Lifecycle Management. The cache serves routes on one graph; capacity is the
+ // number of (start, end, algorithm) results it keeps.
+ RouteCache* route_cache_create(const Graph* graph, int capacity);
+ void route_cache_destroy(RouteCache* cache);
+ void route_cache_clear(RouteCache* cache);
+
+ // Returns the cached route, computing and caching it on a miss (workspace may
+ // be NULL). Any add_node()/add_edge() on the graph invalidates every cached
+ // route; a weight change or closure only drops the routes it can affect.
+ // Safe to call from several threads, each with its own workspace, as long
+ // as nothing modifies the graph meanwhile. Returns NULL on error; a route
+ // that does not exist comes back with result.found == false.
+ const SharedRoute* route_cache_get(RouteCache* cache, SearchWorkspace* workspace, SearchAlgorithm algorithm,
+                                    int start_id, int end_id);
+ void route_cache_release(const SharedRoute* route);
+
+ RouteCacheStats route_cache_stats(RouteCache* cache);
+
+ #endif // ROUTECACHE_H
@@ -0,0 +1,247 @@
+/*
+ * Spatial Index Implementation
+ *
+ * An implicit k-d tree over the nodes' unit-sphere positions (graph.h). The
+ * straight-line chord between two points orders them exactly like their
+ * great-circle distance, so 3-D Euclidean pruning works anywhere on the globe
+ * without a map projection. Each subtree occupies a contiguous slot range
+ * with its splitting point in the middle slot, so the tree needs no child
+ * pointers and queries walk flat arrays.
+ */
+
+ #include "spatial.h"
+ #include "utils.h"
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <math.h>
+ #include <float.h>
+
+ // Tree Construction
+ static inline double coordinate(const SpatialIndex* index, int slot, int axis) {
+     return index->points[3 * slot + axis];
+ }
+
+ static void swap_slots(SpatialIndex* index, int a, int b) {
+     int id = index->node_ids[a];
+     index->node_ids[a] = index->node_ids[b];
+     index->node_ids[b] = id;
+     for (int axis = 0; axis < 3; axis++) {
+         double value = index->points[3 * a + axis];
+         index->points[3 * a + axis] = index->points[3 * b + axis];
+         index->points[3 * b + axis] = value;
+     }
+ }
+
+ // Quickselect: moves the slot that belongs at mid there, with no larger
+ // coordinate before it and no smaller one after it
+ static void select_median(SpatialIndex* index, int lo, int hi, int mid, int axis) {
+     while (hi - lo > 1) {
+         double pivot = coordinate(index, lo + (hi - lo) / 2, axis);
+         int i = lo, j = hi - 1;
+         while (i <= j) {
+             while (coordinate(index, i, axis) < pivot) i++;
+             while (coordinate(index, j, axis) > pivot) j--;
+             if (i <= j) swap_slots(index, i++, j--);
+         }
+         if (mid <= j) hi = j + 1;
+         else if (mid >= i) lo = i;
+         else return;   // Between the partitions every slot equals the pivot
+     }
+ }
+
+ // Splits [lo, hi) at its median along the axis of greatest extent
+ static void build_subtree(SpatialIndex* index, int lo, int hi) {
+     while (hi - lo > 1) {
+         double low[3], high[3];
+         for (int axis = 0; axis < 3; axis++) low[axis] = high[axis] = coordinate(index, lo, axis);
+         for (int slot = lo + 1; slot < hi; slot++) {
+             for (int axis = 0; axis < 3; axis++) {
+                 double value = coordinate(index, slot, axis);
+                 if (value < low[axis]) low[axis] = value;
+                 if (value > high[axis]) high[axis] = value;
+             }
+         }
+         int axis = 0;
+         for (int a = 1; a < 3; a++) {
+             if (high[a] - low[a] > high[axis] - low[axis]) axis = a;
+         }
+
+         int mid = lo + (hi - lo) / 2;
+         select_median(index, lo, hi, mid, axis);
+         index->split[mid] = (unsigned char)axis;
+         build_subtree(index, lo, mid);
+         lo = mid + 1;
+     }
+     if (hi - lo == 1) index->split[lo] = 0;
+ }
+
+ SpatialIndex* spatial_index_build(const Graph* graph) {
+     if (!graph) {
+         fprintf(stderr, "[Spatial Error] spatial_index_build: Graph is NULL\n");
+         return NULL;
+     }
+     int n = get_node_count(graph);
+     size_t slots = n > 0 ? (size_t)n : 1;
+     SpatialIndex* index = malloc(sizeof(SpatialIndex));
+     if (!index) {
+         fprintf(stderr, "[Spatial Error] spatial_index_build: Failed to allocate index\n");
+         return NULL;
+     }
+     index->num_points = n;
+     index->node_ids = malloc(slots * sizeof(int));
+     index->points = malloc(slots * 3 * sizeof(double));
+     index->split = malloc(slots);
+     if (!index->node_ids || !index->points || !index->split) {
+         fprintf(stderr, "[Spatial Error] spatial_index_build: Failed to allocate index for %d nodes\n", n);
+         spatial_index_destroy(index);
+         return NULL;
+     }
+
+     for (int i = 0; i < n; i++) index->node_ids[i] = i;
+     memcpy(index->points, graph->unit_vectors, (size_t)n * 3 * sizeof(double));
+     build_subtree(index, 0, n);
+     return index;
+ }
+
+ void spatial_index_destroy(SpatialIndex* index) {
+     if (!index) return;
+     free(index->node_ids);
+     free(index->points);
+     free(index->split);
+     free(index);
+ }
+
+ // Queries
+ //
+ // The best candidates so far sit in a max-heap on squared chord length, held
+ // in the caller's output arrays; the root is the one to evict next.
+ typedef struct {
+     int* ids;
+     double* chord2;
+     int count;
+     int capacity;
+     double bound;            // Squared chord beyond which nothing is accepted
+ } Candidates;
+
+ static inline double reach(const Candidates* best) {
+     if (best->count < best->capacity) return best->bound;
+     return best->chord2[0] < best->bound ? best->chord2[0] : best->bound;
+ }
+
+ static void sift_down(Candidates* best, int at) {
+     for (;;) {
+         int largest = at;
+         int left = 2 * at + 1, right = left + 1;
+         if (left < best->count && best->chord2[left] > best->chord2[largest]) largest = left;
+         if (right < best->count && best->chord2[right] > best->chord2[largest]) largest = right;
+         if (largest == at) return;
+         double d = best->chord2[at];
+         best->chord2[at] = best->chord2[largest];
+         best->chord2[largest] = d;
+         int id = best->ids[at];
+         best->ids[at] = best->ids[largest];
+         best->ids[largest] = id;
+         at = largest;
+     }
+ }
+
+ static void offer(Candidates* best, double chord2, int node_id) {
+     if (chord2 > best->bound) return;
+     if (best->count < best->capacity) {
+         int at = best->count++;
+         while (at > 0 && best->chord2[(at - 1) / 2] < chord2) {
+             best->chord2[at] = best->chord2[(at - 1) / 2];
+             best->ids[at] = best->ids[(at - 1) / 2];
+             at = (at - 1) / 2;
+         }
+         best->chord2[at] = chord2;
+         best->ids[at] = node_id;
+     } else if (chord2 < best->chord2[0]) {
+         best->chord2[0] = chord2;
+         best->ids[0] = node_id;
+         sift_down(best, 0);
+     }
+ }
+
+ static void search(const SpatialIndex* index, int lo, int hi, const double query[3], Candidates* best) {
+     while (lo < hi) {
+         int mid = lo + (hi - lo) / 2;
+         const double* point = &index->points[3 * mid];
+         double dx = query[0] - point[0];
+         double dy = query[1] - point[1];
+         double dz = query[2] - point[2];
+         offer(best, dx * dx + dy * dy + dz * dz, index->node_ids[mid]);
+
+         // The query's side first; the other only if the splitting plane is in reach
+         int axis = index->split[mid];
+         double gap = query[axis] - point[axis];
+         if (gap < 0) {
+             search(index, lo, mid, query, best);
+             lo = mid + 1;
+         } else {
+             search(index, mid + 1, hi, query, best);
+             hi = mid;
+         }
+         if (gap * gap > reach(best)) return;
+     }
+ }
+
+ // Runs the query and rewrites the heap as nearest-first great-circle kilometres
+ static int collect(const SpatialIndex* index, double latitude, double longitude, int capacity, double bound,
+                    int* node_ids, double* distances_km) {
+     Candidates best = { .ids = node_ids, .chord2 = distances_km, .count = 0, .capacity = capacity, .bound = bound };
+     double query[3];
+     unit_vector(latitude, longitude, query);
+     if (capacity > 0) search(index, 0, index->num_points, query, &best);
+
+     int found = best.count;
+     while (best.count > 1) {
+         int last = --best.count;
+         double d = best.chord2[0];
+         best.chord2[0] = best.chord2[last];
+         best.chord2[last] = d;
+         int id = best.ids[0];
+         best.ids[0] = best.ids[last];
+         best.ids[last] = id;
+         sift_down(&best, 0);
+     }
+     for (int i = 0; i < found; i++) {
+         double half_chord = 0.5 * sqrt(distances_km[i]);
+         distances_km[i] = 2.0 * EARTH_RADIUS_KM * asin(half_chord < 1.0 ? half_chord : 1.0);
+     }
+     return found;
+ }
+
+ int spatial_nearest(const SpatialIndex* index, double latitude, double longitude, double* distance_km) {
+     if (!index) {
+         fprintf(stderr, "[Spatial Error] spatial_nearest: Index is NULL\n");
+         return -1;
+     }
+     int node_id;
+     double distance;
+     if (collect(index, latitude, longitude, 1, DBL_MAX, &node_id, &distance) == 0) return -1;
+     if (distance_km) *distance_km = distance;
+     return node_id;
+ }
+
+ int spatial_k_nearest(const SpatialIndex* index, double latitude, double longitude, int k,
+                       int* node_ids, double* distances_km) {
+     if (!index || k < 0 || (k > 0 && (!node_ids || !distances_km))) {
+         fprintf(stderr, "[Spatial Error] spatial_k_nearest: Index or output is NULL, or k is negative\n");
+         return -1;
+     }
+     return collect(index, latitude, longitude, k, DBL_MAX, node_ids, distances_km);
+ }
+
+ int spatial_within_radius(const SpatialIndex* index, double latitude, double longitude, double radius_km,
+                           int max_results, int* node_ids, double* distances_km) {
+     if (!index || max_results < 0 || radius_km < 0 || (max_results > 0 && (!node_ids || !distances_km))) {
+         fprintf(stderr, "[Spatial Error] spatial_within_radius: Index or output is NULL, or a bound is negative\n");
+         return -1;
+     }
+     // Chord subtending radius_km of arc; past the antipode everything is in range
+     double angle = radius_km / EARTH_RADIUS_KM;
+     double chord = angle < PI ? 2.0 * sin(0.5 * angle) : 2.0;
+     return collect(index, latitude, longitude, max_results, chord * chord * (1.0 + 1e-12), node_ids, distances_km);
+ }
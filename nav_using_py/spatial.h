@@ -0,0 +1,32 @@
+/*
+ * Spatial Index - Nearest-node lookups from latitude/longitude.
+ */
+
+ #ifndef SPATIAL_H
+ #define SPATIAL_H
+
+ #include "graph.h"
+
+ typedef struct {
+     int num_points;
+     int* node_ids;           // Node at each tree slot
+     double* points;          // Unit-sphere x, y, z per tree slot
+     unsigned char* split;    // Axis each slot splits its subtree on
+ } SpatialIndex;
+
+ // Lifecycle Management. The index copies the node coordinates, so it must be
+ // rebuilt after nodes are added.
+ SpatialIndex* spatial_index_build(const Graph* graph);
+ void spatial_index_destroy(SpatialIndex* index);
+
+ // Queries. Distances are great-circle kilometres and results are ordered
+ // nearest first. spatial_nearest() returns the node ID (-1 if the index is
+ // empty); the others return the number of nodes written, or -1 on error.
+ // spatial_within_radius() keeps the max_results nearest of the matches.
+ int spatial_nearest(const SpatialIndex* index, double latitude, double longitude, double* distance_km);
+ int spatial_k_nearest(const SpatialIndex* index, double latitude, double longitude, int k,
+                       int* node_ids, double* distances_km);
+ int spatial_within_radius(const SpatialIndex* index, double latitude, double longitude, double radius_km,
+                           int max_results, int* node_ids, double* distances_km);
+
+ #endif // SPATIAL_H
@@ -0,0 +1,189 @@
+/*
+ * Shortest Path Tree Implementation
+ *
+ * A tree is one full Dijkstra search whose labels are copied out of the
+ * workspace before it is reused. Routes to any target are then predecessor
+ * walks, so "from here to everywhere" costs one search instead of one per
+ * target. After live updates the tree is repaired in place from the graph's
+ * change log (dijkstra_repair_tree_ws) instead of being searched again.
+ */
+
+ #include "spt.h"
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+
+ // Copies a fresh search from tree->source_id into the tree's arrays
+ static bool fill_tree(ShortestPathTree* tree, const Graph* graph, SearchWorkspace* ws) {
+     int reached = dijkstra_settle_all_ws(graph, ws, tree->source_id, false, tree->order);
+     if (reached == 0) return false;
+
+     for (int v = 0; v < tree->num_nodes; v++) {
+         tree->distances[v] = DBL_MAX;
+         tree->predecessors[v] = -1;
+     }
+     for (int i = 0; i < reached; i++) {
+         int v = tree->order[i];
+         tree->distances[v] = ws->forward.distance[v];
+         tree->predecessors[v] = ws->forward.predecessor[v];
+     }
+     tree->num_reached = reached;
+     tree->graph_version = graph_version(graph);
+     return true;
+ }
+
+ ShortestPathTree* shortest_path_tree_ws(const Graph* graph, SearchWorkspace* ws, int source_id) {
+     if (!ws || !is_valid_node(graph, source_id)) {
+         fprintf(stderr, "[Tree Error] shortest_path_tree: Invalid workspace or source node %d\n", source_id);
+         return NULL;
+     }
+     int n = get_node_count(graph);
+     ShortestPathTree* tree = malloc(sizeof(ShortestPathTree));
+     void* buffer = malloc((size_t)n * (sizeof(double) + 2 * sizeof(int)));
+     if (!tree || !buffer) {
+         fprintf(stderr, "[Tree Error] shortest_path_tree: Failed to allocate a tree of %d nodes\n", n);
+         free(tree);
+         free(buffer);
+         return NULL;
+     }
+     tree->source_id = source_id;
+     tree->num_nodes = n;
+     tree->distances = buffer;
+     tree->predecessors = (int*)(tree->distances + n);
+     tree->order = tree->predecessors + n;
+     if (!fill_tree(tree, graph, ws)) {
+         shortest_path_tree_destroy(tree);
+         return NULL;
+     }
+     return tree;
+ }
+
+ // One-shot trees use a temporary workspace
+ ShortestPathTree* shortest_path_tree(const Graph* graph, int source_id) {
+     SearchWorkspace* ws = search_workspace_create(get_node_count(graph));
+     if (!ws) return NULL;
+     ShortestPathTree* tree = shortest_path_tree_ws(graph, ws, source_id);
+     search_workspace_destroy(ws);
+     return tree;
+ }
+
+ void shortest_path_tree_destroy(ShortestPathTree* tree) {
+     if (!tree) return;
+     free(tree->distances);   // Owns the predecessor and order arrays too
+     free(tree);
+ }
+
+ // Updates
+
+ typedef struct {
+     double distance;
+     int depth;
+     int node_id;
+ } OrderKey;
+
+ static int compare_order(const void* a, const void* b) {
+     const OrderKey* x = a;
+     const OrderKey* y = b;
+     if (x->distance != y->distance) return x->distance < y->distance ? -1 : 1;
+     if (x->depth != y->depth) return x->depth < y->depth ? -1 : 1;
+     return (x->node_id > y->node_id) - (x->node_id < y->node_id);
+ }
+
+ // Re-derives the order after a repair. Ties in distance (zero-weight edges)
+ // are broken by tree depth so parents still precede their children.
+ static bool rebuild_order(ShortestPathTree* tree) {
+     int n = tree->num_nodes;
+     int* depth = malloc((size_t)n * sizeof(int));
+     OrderKey* keys = malloc((size_t)n * sizeof(OrderKey));
+     if (!depth || !keys) {
+         fprintf(stderr, "[Tree Error] shortest_path_tree_update: Failed to allocate order of %d nodes\n", n);
+         free(depth);
+         free(keys);
+         return false;
+     }
+     for (int v = 0; v < n; v++) depth[v] = -1;
+     depth[tree->source_id] = 0;
+
+     int* chain = tree->order;   // Scratch until the order is rewritten
+     int reached = 0;
+     for (int v = 0; v < n; v++) {
+         if (tree->distances[v] == DBL_MAX) continue;
+         int length = 0;
+         int up = v;
+         while (depth[up] < 0) {
+             chain[length++] = up;
+             up = tree->predecessors[up];
+         }
+         while (length > 0) {
+             int node_id = chain[--length];
+             depth[node_id] = depth[tree->predecessors[node_id]] + 1;
+         }
+         keys[reached].distance = tree->distances[v];
+         keys[reached].depth = depth[v];
+         keys[reached].node_id = v;
+         reached++;
+     }
+     qsort(keys, reached, sizeof(OrderKey), compare_order);
+     for (int i = 0; i < reached; i++) tree->order[i] = keys[i].node_id;
+     tree->num_reached = reached;
+
+     free(depth);
+     free(keys);
+     return true;
+ }
+
+ bool shortest_path_tree_update(ShortestPathTree* tree, const Graph* graph, SearchWorkspace* ws) {
+     if (!tree || !graph || !ws) {
+         fprintf(stderr, "[Tree Error] shortest_path_tree_update: Tree, graph or workspace is NULL\n");
+         return false;
+     }
+     if (tree->graph_version == graph_version(graph)) return true;
+     if (tree->num_nodes != get_node_count(graph)) {
+         fprintf(stderr, "[Tree Error] shortest_path_tree_update: Graph has %d nodes, tree has %d; build a new tree\n",
+                 get_node_count(graph), tree->num_nodes);
+         return false;
+     }
+
+     const GraphChange* changes;
+     int num_changes = graph_changes_since(graph, tree->graph_version, &changes);
+     if (num_changes < 0) return fill_tree(tree, graph, ws);
+
+     int relabelled = dijkstra_repair_tree_ws(graph, ws, tree->source_id, tree->distances, tree->predecessors,
+                                              changes, num_changes);
+     if (relabelled < 0) return false;
+     if (relabelled > 0 && !rebuild_order(tree)) return false;
+     tree->graph_version = graph_version(graph);
+     return true;
+ }
+
+ // Queries
+
+ double shortest_path_tree_distance(const ShortestPathTree* tree, int target_id) {
+     if (!tree || target_id < 0 || target_id >= tree->num_nodes) return DBL_MAX;
+     return tree->distances[target_id];
+ }
+
+ PathResult shortest_path_tree_path(const ShortestPathTree* tree, int target_id) {
+     PathResult result = { .found = false };
+     if (shortest_path_tree_distance(tree, target_id) == DBL_MAX) return result;
+
+     int length = 1;
+     for (int v = target_id; v != tree->source_id; v = tree->predecessors[v]) length++;
+     result.path = malloc((size_t)length * sizeof(int));
+     if (!result.path) {
+         fprintf(stderr, "[Tree Error] shortest_path_tree_path: Failed to allocate path of %d nodes\n", length);
+         return result;
+     }
+     int slot = length;
+     for (int v = target_id; slot > 0; v = tree->predecessors[v]) result.path[--slot] = v;
+     result.path_length = length;
+     result.total_distance = tree->distances[target_id];
+     result.found = true;
+     result.owns_path = true;
+     return result;
+ }
+
+ double shortest_path_tree_max_distance(const ShortestPathTree* tree) {
+     if (!tree || tree->num_reached == 0) return 0.0;
+     return tree->distances[tree->order[tree->num_reached - 1]];
+ }
@@ -0,0 +1,147 @@
+/*
+ * String Table Implementation
+ *
+ * Strings are hashed with FNV-1a into an open-addressing table of IDs with
+ * linear probing. Copied text lives in the table's arena, so freeing the
+ * table releases every string in a few block frees.
+ */
+
+ #include "strtab.h"
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+
+ #define STRTAB_INITIAL_CAPACITY 64
+
+ static uint32_t hash_text(const char* text, size_t length) {
+     uint32_t hash = 2166136261u;
+     for (size_t i = 0; i < length; i++) {
+         hash ^= (unsigned char)text[i];
+         hash *= 16777619u;
+     }
+     return hash;
+ }
+
+ bool strtab_init(StringTable* table) {
+     memset(table, 0, sizeof(StringTable));
+     arena_init(&table->arena);
+     table->strings = malloc(STRTAB_INITIAL_CAPACITY * sizeof(const char*));
+     table->hashes = malloc(STRTAB_INITIAL_CAPACITY * sizeof(uint32_t));
+     table->slots = calloc(STRTAB_INITIAL_CAPACITY * 2, sizeof(int));
+     if (!table->strings || !table->hashes || !table->slots) {
+         fprintf(stderr, "[Strtab Error] strtab_init: Failed to allocate string table\n");
+         strtab_free(table);
+         return false;
+     }
+     table->capacity = STRTAB_INITIAL_CAPACITY;
+     table->slot_capacity = STRTAB_INITIAL_CAPACITY * 2;
+     return true;
+ }
+
+ void strtab_free(StringTable* table) {
+     free(table->strings);
+     free(table->hashes);
+     free(table->slots);
+     arena_free(&table->arena);
+     table->strings = NULL;
+     table->hashes = NULL;
+     table->slots = NULL;
+     table->count = 0;
+     table->capacity = 0;
+     table->slot_capacity = 0;
+ }
+
+ // Slot holding text, or the empty slot where it would go
+ static int find_slot(const StringTable* table, const char* text, size_t length, uint32_t hash) {
+     int mask = table->slot_capacity - 1;
+     int slot = (int)(hash & (uint32_t)mask);
+     while (table->slots[slot] != 0) {
+         int id = table->slots[slot] - 1;
+         if (table->hashes[id] == hash && strncmp(table->strings[id], text, length) == 0
+             && table->strings[id][length] == '\0') {
+             return slot;
+         }
+         slot = (slot + 1) & mask;
+     }
+     return slot;
+ }
+
+ static bool grow(StringTable* table) {
+     int capacity = table->capacity * 2;
+     const char** strings = realloc(table->strings, capacity * sizeof(const char*));
+     if (strings) table->strings = strings;
+     uint32_t* hashes = realloc(table->hashes, capacity * sizeof(uint32_t));
+     if (hashes) table->hashes = hashes;
+     int* slots = calloc((size_t)capacity * 2, sizeof(int));
+     if (!strings || !hashes || !slots) {
+         fprintf(stderr, "[Strtab Error] strtab_intern: Failed to grow to %d strings\n", capacity);
+         free(slots);
+         return false;
+     }
+     table->capacity = capacity;
+
+     // Reinsert by stored hash; IDs are distinct so no comparisons are needed
+     free(table->slots);
+     table->slots = slots;
+     table->slot_capacity = capacity * 2;
+     int mask = table->slot_capacity - 1;
+     for (int id = 0; id < table->count; id++) {
+         int slot = (int)(table->hashes[id] & (uint32_t)mask);
+         while (slots[slot] != 0) slot = (slot + 1) & mask;
+         slots[slot] = id + 1;
+     }
+     return true;
+ }
+
+ // Text is compared as a C string, so it ends at an embedded NUL
+ static size_t c_length(const char* text, size_t length) {
+     const char* nul = memchr(text, '\0', length);
+     return nul ? (size_t)(nul - text) : length;
+ }
+
+ static int intern(StringTable* table, const char* text, size_t length, bool copy) {
+     length = c_length(text, length);
+     uint32_t hash = hash_text(text, length);
+     int slot = find_slot(table, text, length, hash);
+     if (table->slots[slot] != 0) return table->slots[slot] - 1;
+
+     if (table->count == table->capacity) {
+         if (!grow(table)) return -1;
+         slot = find_slot(table, text, length, hash);
+     }
+     const char* stored = text;
+     if (copy) {
+         char* duplicate = arena_alloc(&table->arena, length + 1);
+         if (!duplicate) return -1;
+         memcpy(duplicate, text, length);
+         duplicate[length] = '\0';
+         stored = duplicate;
+     }
+     int id = table->count++;
+     table->strings[id] = stored;
+     table->hashes[id] = hash;
+     table->slots[slot] = id + 1;
+     return id;
+ }
+
+ int strtab_intern(StringTable* table, const char* text, size_t length) {
+     if (!table || !text || table->slot_capacity == 0) return -1;
+     return intern(table, text, length, true);
+ }
+
+ int strtab_intern_static(StringTable* table, const char* text) {
+     if (!table || !text || table->slot_capacity == 0) return -1;
+     return intern(table, text, strlen(text), false);
+ }
+
+ int strtab_find(const StringTable* table, const char* text, size_t length) {
+     if (!table || !text || table->slot_capacity == 0) return -1;
+     length = c_length(text, length);
+     int slot = find_slot(table, text, length, hash_text(text, length));
+     return table->slots[slot] - 1;
+ }
+
+ const char* strtab_get(const StringTable* table, int id) {
+     if (!table || id < 0 || id >= table->count) return NULL;
+     return table->strings[id];
+ }
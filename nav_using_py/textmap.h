@@ -0,0 +1,14 @@
+/*
+ * Text Map Parser - Streaming, multi-threaded reader for the .txt road network format.
+ */
+
+ #ifndef TEXTMAP_H
+ #define TEXTMAP_H
+
+ #include "graph.h"
+
+ // Appends the nodes and edges of a text map to an empty graph without freezing it.
+ // Malformed lines are reported as file:line:column and skipped.
+ bool load_text_map(Graph* graph, const char* filename);
+
+ #endif // TEXTMAP_H
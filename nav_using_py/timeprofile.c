@@ -0,0 +1,485 @@
+/*
+ * Time Profile Implementation
+ *
+ * A profile is a short list of (time of day, factor) points shared by every
+ * edge that uses it; an edge's travel time at time t is its static weight at
+ * walking speed times the profile's factor at t. Edges store a 16-bit profile
+ * id, so a map of millions of edges costs two bytes per edge plus the
+ * profiles themselves.
+ *
+ * The searches are Dijkstra and A* on arrival times. That is exact when no
+ * edge lets a later start arrive earlier (FIFO), which time_profiles_arrival()
+ * guarantees by letting a traveller wait for a factor to drop.
+ */
+
+ #define _POSIX_C_SOURCE 200809L
+
+ #include "timeprofile.h"
+ #include "utils.h"
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <math.h>
+
+ // Parsing
+
+ typedef struct {
+     int id;
+     int first_point;
+     int num_points;
+     long line;
+ } ParsedProfile;
+
+ typedef struct {
+     int source_id;
+     int destination_id;
+     int id;
+     long line;
+ } ParsedAssignment;
+
+ typedef struct {
+     const char* filename;
+     ParsedProfile* profiles;
+     int num_profiles;
+     int profiles_capacity;
+     ProfilePoint* points;
+     int num_points;
+     int points_capacity;
+     ParsedAssignment* assignments;
+     int num_assignments;
+     int assignments_capacity;
+     bool out_of_memory;
+ } ProfileLoad;
+
+ static void report(const ProfileLoad* load, long line, const char* message) {
+     fprintf(stderr, "[TimeProfile Error] time_profiles_load: %s:%ld: %s\n", load->filename, line, message);
+ }
+
+ // Grows *items to hold one more element of the given size
+ static bool reserve_one(ProfileLoad* load, void** items, int count, int* capacity, size_t size) {
+     if (count < *capacity) return true;
+     int grown = *capacity > 0 ? *capacity * 2 : 64;
+     void* resized = realloc(*items, (size_t)grown * size);
+     if (!resized) {
+         load->out_of_memory = true;
+         return false;
+     }
+     *items = resized;
+     *capacity = grown;
+     return true;
+ }
+
+ // Reads "HH:MM" or "HH:MM:SS" as seconds since midnight
+ static bool parse_time_of_day(char** cursor, double* seconds) {
+     int hours, minutes, secs = 0, used = 0;
+     if (sscanf(*cursor, " %d:%d%n", &hours, &minutes, &used) != 2) return false;
+     char* p = *cursor + used;
+     if (*p == ':') {
+         int more = 0;
+         if (sscanf(p, ":%d%n", &secs, &more) != 1) return false;
+         p += more;
+     }
+     if (hours < 0 || hours > 23 || minutes < 0 || minutes > 59 || secs < 0 || secs > 59) return false;
+     *seconds = hours * 3600.0 + minutes * 60.0 + secs;
+     *cursor = p;
+     return true;
+ }
+
+ static bool parse_id(char** cursor, int* value) {
+     char* end;
+     long parsed = strtol(*cursor, &end, 10);
+     if (end == *cursor || parsed < INT32_MIN || parsed > INT32_MAX) return false;
+     *value = (int)parsed;
+     *cursor = end;
+     return true;
+ }
+
+ static bool at_line_end(const char* p) {
+     while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+     return *p == '\0' || *p == '#';
+ }
+
+ static void parse_profile_line(ProfileLoad* load, char* p, long line) {
+     int id;
+     if (!parse_id(&p, &id) || id < 1 || id > TIME_PROFILE_MAX_ID) {
+         report(load, line, "expected a profile id from 1 to 65535");
+         return;
+     }
+     int first = load->num_points;
+     double previous_time = -1.0;
+     while (!at_line_end(p)) {
+         double time, factor;
+         if (!parse_time_of_day(&p, &time)) {
+             report(load, line, "expected a time of day as HH:MM");
+             load->num_points = first;
+             return;
+         }
+         char* end;
+         factor = strtod(p, &end);
+         if (end == p || !(factor > 0.0) || !isfinite(factor)) {
+             report(load, line, "expected a positive factor after each time");
+             load->num_points = first;
+             return;
+         }
+         p = end;
+         if (time <= previous_time) {
+             report(load, line, "profile times must increase");
+             load->num_points = first;
+             return;
+         }
+         previous_time = time;
+         if (!reserve_one(load, (void**)&load->points, load->num_points, &load->points_capacity, sizeof(ProfilePoint))) {
+             return;
+         }
+         load->points[load->num_points++] = (ProfilePoint){ .time = (float)time, .factor = (float)factor };
+     }
+     if (load->num_points == first) {
+         report(load, line, "profile has no points");
+         return;
+     }
+     if (!reserve_one(load, (void**)&load->profiles, load->num_profiles, &load->profiles_capacity, sizeof(ParsedProfile))) {
+         return;
+     }
+     load->profiles[load->num_profiles++] = (ParsedProfile){
+         .id = id, .first_point = first, .num_points = load->num_points - first, .line = line
+     };
+ }
+
+ static void parse_assignment_line(ProfileLoad* load, char* p, long line) {
+     ParsedAssignment assignment = { .line = line };
+     if (!parse_id(&p, &assignment.source_id) || !parse_id(&p, &assignment.destination_id)
+         || !parse_id(&p, &assignment.id) || !at_line_end(p)) {
+         report(load, line, "expected source node ID, destination node ID and profile id");
+         return;
+     }
+     if (!reserve_one(load, (void**)&load->assignments, load->num_assignments, &load->assignments_capacity,
+                      sizeof(ParsedAssignment))) {
+         return;
+     }
+     load->assignments[load->num_assignments++] = assignment;
+ }
+
+ // Matches a keyword followed by a blank, advancing past it
+ static bool take_keyword(char** cursor, const char* keyword) {
+     size_t length = strlen(keyword);
+     if (strncmp(*cursor, keyword, length) != 0 || ((*cursor)[length] != ' ' && (*cursor)[length] != '\t')) {
+         return false;
+     }
+     *cursor += length;
+     return true;
+ }
+
+ // Building
+
+ // Steepest fall of a profile's factor per second, over every segment including the one across midnight
+ static float profile_min_slope(const ProfilePoint* points, int num_points) {
+     float min_slope = 0.0f;
+     for (int i = 0; i < num_points; i++) {
+         const ProfilePoint* a = &points[i];
+         const ProfilePoint* b = &points[(i + 1) % num_points];
+         double span = b->time - a->time;
+         if (span <= 0.0) span += TIME_PROFILE_DAY_SECONDS;
+         float slope = (float)((b->factor - a->factor) / span);
+         if (slope < min_slope) min_slope = slope;
+     }
+     return min_slope;
+ }
+
+ // Sets the profile of every source_id -> destination_id edge; returns how many there were
+ static int assign_edges(TimeProfiles* profiles, const Graph* graph, int source_id, int destination_id, int id) {
+     int assigned = 0;
+     for (int e = graph->edge_offsets[source_id]; e < graph->edge_offsets[source_id + 1]; e++) {
+         if (graph->edge_targets[e] == destination_id) {
+             profiles->edge_profiles[e] = (uint16_t)id;
+             assigned++;
+         }
+     }
+     return assigned;
+ }
+
+ static TimeProfiles* build_profiles(const Graph* graph, ProfileLoad* load) {
+     int num_edges = graph->edge_offsets[get_node_count(graph)];
+     int max_id = 0;
+     for (int i = 0; i < load->num_profiles; i++) {
+         if (load->profiles[i].id > max_id) max_id = load->profiles[i].id;
+     }
+
+     TimeProfiles* profiles = calloc(1, sizeof(TimeProfiles));
+     if (!profiles) return NULL;
+     profiles->num_nodes = get_node_count(graph);
+     profiles->num_edges = num_edges;
+     profiles->seconds_per_km = 3600.0 / TIME_PROFILE_WALKING_SPEED_KMH;
+     profiles->num_profiles = max_id + 1;
+     profiles->profiles = calloc((size_t)profiles->num_profiles, sizeof(TravelProfile));
+     profiles->points = malloc((size_t)(load->num_points > 0 ? load->num_points : 1) * sizeof(ProfilePoint));
+     profiles->edge_profiles = calloc((size_t)(num_edges > 0 ? num_edges : 1), sizeof(uint16_t));
+     if (!profiles->profiles || !profiles->points || !profiles->edge_profiles) {
+         time_profiles_destroy(profiles);
+         return NULL;
+     }
+
+     // Points are copied only for the first definition of each id
+     profiles->min_factor = 1.0;
+     for (int i = 0; i < load->num_profiles; i++) {
+         const ParsedProfile* parsed = &load->profiles[i];
+         TravelProfile* profile = &profiles->profiles[parsed->id];
+         if (profile->num_points > 0) {
+             report(load, parsed->line, "profile id already defined; line ignored");
+             continue;
+         }
+         profile->first_point = profiles->num_points;
+         profile->num_points = parsed->num_points;
+         memcpy(&profiles->points[profiles->num_points], &load->points[parsed->first_point],
+                (size_t)parsed->num_points * sizeof(ProfilePoint));
+         profiles->num_points += parsed->num_points;
+         profile->min_slope = profile_min_slope(&profiles->points[profile->first_point], profile->num_points);
+         for (int p = 0; p < parsed->num_points; p++) {
+             double factor = profiles->points[profile->first_point + p].factor;
+             if (factor < profiles->min_factor) profiles->min_factor = factor;
+         }
+     }
+
+     for (int i = 0; i < load->num_assignments; i++) {
+         const ParsedAssignment* assignment = &load->assignments[i];
+         int u = assignment->source_id;
+         int v = assignment->destination_id;
+         if (assignment->id < 1 || assignment->id >= profiles->num_profiles
+             || profiles->profiles[assignment->id].num_points == 0) {
+             report(load, assignment->line, "undefined profile id");
+         } else if (!is_valid_node(graph, u) || !is_valid_node(graph, v)) {
+             report(load, assignment->line, "node ID out of range");
+         } else if (assign_edges(profiles, graph, u, v, assignment->id)
+                    + assign_edges(profiles, graph, v, u, assignment->id) == 0) {
+             report(load, assignment->line, "no edge between these nodes");
+         }
+     }
+     return profiles;
+ }
+
+ TimeProfiles* time_profiles_load(const Graph* graph, const char* filename) {
+     if (!graph || !filename) {
+         fprintf(stderr, "[TimeProfile Error] time_profiles_load: Graph or filename is NULL\n");
+         return NULL;
+     }
+     if (!is_graph_frozen(graph)) {
+         fprintf(stderr, "[TimeProfile Error] time_profiles_load: Graph is not frozen (call graph_freeze)\n");
+         return NULL;
+     }
+     FILE* file = fopen(filename, "r");
+     if (!file) {
+         fprintf(stderr, "[TimeProfile Error] time_profiles_load: Could not open file '%s'\n", filename);
+         return NULL;
+     }
+
+     ProfileLoad load = { .filename = filename };
+     char* line = NULL;
+     size_t line_capacity = 0;
+     long line_number = 0;
+     while (!load.out_of_memory && getline(&line, &line_capacity, file) != -1) {
+         line_number++;
+         char* p = line;
+         while (*p == ' ' || *p == '\t') p++;
+         if (take_keyword(&p, "profile")) parse_profile_line(&load, p, line_number);
+         else if (take_keyword(&p, "edge_profile")) parse_assignment_line(&load, p, line_number);
+     }
+     free(line);
+     fclose(file);
+
+     TimeProfiles* profiles = NULL;
+     if (!load.out_of_memory) profiles = build_profiles(graph, &load);
+     if (!profiles) fprintf(stderr, "[TimeProfile Error] time_profiles_load: Out of memory reading '%s'\n", filename);
+     free(load.profiles);
+     free(load.points);
+     free(load.assignments);
+     return profiles;
+ }
+
+ void time_profiles_destroy(TimeProfiles* profiles) {
+     if (!profiles) return;
+     free(profiles->profiles);
+     free(profiles->points);
+     free(profiles->edge_profiles);
+     free(profiles);
+ }
+
+ // Evaluation
+
+ // Factor at a time of day, linear between points and across midnight
+ static double profile_factor(const TimeProfiles* profiles, const TravelProfile* profile, double time_of_day) {
+     const ProfilePoint* points = &profiles->points[profile->first_point];
+     int n = profile->num_points;
+     if (n == 1) return points[0].factor;
+
+     // Last point at or before the time; -1 means the segment from the previous day's last point
+     int low = 0, high = n - 1, before = -1;
+     while (low <= high) {
+         int mid = (low + high) / 2;
+         if (points[mid].time <= time_of_day) {
+             before = mid;
+             low = mid + 1;
+         } else {
+             high = mid - 1;
+         }
+     }
+     const ProfilePoint* a = &points[before >= 0 ? before : n - 1];
+     const ProfilePoint* b = &points[before >= 0 && before + 1 < n ? before + 1 : 0];
+     double a_time = a->time, b_time = b->time;
+     if (before < 0) a_time -= TIME_PROFILE_DAY_SECONDS;
+     if (b_time <= a_time) b_time += TIME_PROFILE_DAY_SECONDS;
+     double fraction = (time_of_day - a_time) / (b_time - a_time);
+     return a->factor + fraction * (b->factor - a->factor);
+ }
+
+ static inline double time_of_day(double time) {
+     double day_time = fmod(time, TIME_PROFILE_DAY_SECONDS);
+     return day_time < 0.0 ? day_time + TIME_PROFILE_DAY_SECONDS : day_time;
+ }
+
+ double time_profiles_arrival(const TimeProfiles* profiles, const Graph* graph, int edge_index, double departure_time) {
+     double base = graph->edge_weights[edge_index] * profiles->seconds_per_km;
+     int id = profiles->edge_profiles[edge_index];
+     if (id == 0 || !isfinite(base)) return departure_time + base;
+
+     const TravelProfile* profile = &profiles->profiles[id];
+     double day_time = time_of_day(departure_time);
+     double arrival = departure_time + base * profile_factor(profiles, profile, day_time);
+     if (base * profile->min_slope >= -1.0) return arrival;
+
+     // Arrival is linear between the profile's points, so the best wait ends at one of them
+     const ProfilePoint* points = &profiles->points[profile->first_point];
+     double day_start = departure_time - day_time;
+     for (int i = 0; i < profile->num_points; i++) {
+         double point_time = day_start + points[i].time;
+         if (point_time <= departure_time) point_time += TIME_PROFILE_DAY_SECONDS;
+         double waited = point_time + base * points[i].factor;
+         if (waited < arrival) arrival = waited;
+     }
+     return arrival;
+ }
+
+ // Searches
+
+ static bool profiles_match(const TimeProfiles* profiles, const Graph* graph) {
+     return profiles && is_graph_frozen(graph) && profiles->num_nodes == get_node_count(graph)
+            && profiles->num_edges == graph->edge_offsets[get_node_count(graph)];
+ }
+
+ // Lower bound on the travel time to end_id: straight-line distance at the
+ // smallest factor of any profile
+ static inline double td_heuristic(const Graph* graph, const TimeProfiles* profiles, int node_id, int end_id) {
+     const double* a = &graph->unit_vectors[3 * node_id];
+     const double* b = &graph->unit_vectors[3 * end_id];
+     double dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+     return EARTH_RADIUS_KM * sqrt(dx * dx + dy * dy + dz * dz) * profiles->seconds_per_km * profiles->min_factor;
+ }
+
+ // Walks the predecessors back from end_id. Of parallel edges, the length
+ // counted is that of the one giving the recorded arrival.
+ static void reconstruct_timed_path(const Graph* graph, const TimeProfiles* profiles, const SearchWorkspace* ws,
+                                    int end_id, PathResult* result) {
+     const SearchSide* fwd = &ws->forward;
+     int length = 0;
+     for (int v = end_id; v != -1; v = fwd->predecessor[v]) length++;
+     result->path = malloc((size_t)length * sizeof(int));
+     if (!result->path) {
+         fprintf(stderr, "[TimeProfile Error] td_shortest_path: Failed to allocate path of %d nodes\n", length);
+         return;
+     }
+     double distance_km = 0.0;
+     int slot = length;
+     for (int v = end_id; v != -1; v = fwd->predecessor[v]) {
+         result->path[--slot] = v;
+         int u = fwd->predecessor[v];
+         if (u == -1) continue;
+         double best_arrival = DBL_MAX, best_weight = 0.0;
+         for (int e = graph->edge_offsets[u]; e < graph->edge_offsets[u + 1]; e++) {
+             if (graph->edge_targets[e] != v) continue;
+             double arrival = time_profiles_arrival(profiles, graph, e, fwd->distance[u]);
+             if (arrival < best_arrival) {
+                 best_arrival = arrival;
+                 best_weight = graph->edge_weights[e];
+             }
+         }
+         distance_km += best_weight;
+     }
+     result->path_length = length;
+     result->total_distance = distance_km;
+     result->found = true;
+     result->owns_path = true;
+ }
+
+ // Labels are arrival times; with guided set, heap keys add td_heuristic()
+ static inline PathResult td_search(const Graph* graph, const TimeProfiles* profiles, SearchWorkspace* ws,
+                                    int start_id, int end_id, double departure_time, double* arrival_time,
+                                    bool guided) {
+     PathResult result = { .found = false };
+     if (arrival_time) *arrival_time = DBL_MAX;
+     if (!ws || !is_valid_node(graph, start_id) || !is_valid_node(graph, end_id)) return result;
+     if (!profiles_match(profiles, graph)) {
+         fprintf(stderr, "[TimeProfile Error] td_shortest_path: Profiles missing or built for another graph\n");
+         return result;
+     }
+     if (!search_workspace_begin(ws, get_node_count(graph), false)) return result;
+
+     SearchSide* fwd = &ws->forward;
+     unsigned int gen = ws->generation;
+     double* arrivals = fwd->distance;
+     IndexedHeap* pq = &fwd->heap;
+
+     side_touch(fwd, gen, start_id);
+     arrivals[start_id] = departure_time;
+     heap_push_or_decrease(pq, start_id, departure_time + (guided ? td_heuristic(graph, profiles, start_id, end_id) : 0.0));
+     while (!heap_is_empty(pq)) {
+         int current_id = heap_pop_min(pq, NULL);
+         side_settle(ws, fwd, current_id);
+         if (current_id == end_id) break;
+         for (int e = graph->edge_offsets[current_id]; e < graph->edge_offsets[current_id + 1]; e++) {
+             int neighbor_id = graph->edge_targets[e];
+             if (side_is_settled(fwd, gen, neighbor_id)) continue;
+             side_touch(fwd, gen, neighbor_id);
+             double arrival = time_profiles_arrival(profiles, graph, e, arrivals[current_id]);
+             if (arrival < arrivals[neighbor_id]) {
+                 arrivals[neighbor_id] = arrival;
+                 fwd->predecessor[neighbor_id] = current_id;
+                 double key = arrival + (guided ? td_heuristic(graph, profiles, neighbor_id, end_id) : 0.0);
+                 heap_push_or_decrease(pq, neighbor_id, key);
+             }
+         }
+     }
+     if (!side_reached(fwd, gen, end_id)) return result;
+
+     reconstruct_timed_path(graph, profiles, ws, end_id, &result);
+     if (result.found && arrival_time) *arrival_time = arrivals[end_id];
+     return result;
+ }
+
+ PathResult td_dijkstra_shortest_path_ws(const Graph* graph, const TimeProfiles* profiles, SearchWorkspace* ws,
+                                         int start_id, int end_id, double departure_time, double* arrival_time) {
+     return td_search(graph, profiles, ws, start_id, end_id, departure_time, arrival_time, false);
+ }
+
+ PathResult td_a_star_shortest_path_ws(const Graph* graph, const TimeProfiles* profiles, SearchWorkspace* ws,
+                                       int start_id, int end_id, double departure_time, double* arrival_time) {
+     return td_search(graph, profiles, ws, start_id, end_id, departure_time, arrival_time, true);
+ }
+
+ // One-shot queries use a temporary workspace
+ PathResult td_dijkstra_shortest_path(const Graph* graph, const TimeProfiles* profiles, int start_id, int end_id,
+                                      double departure_time, double* arrival_time) {
+     PathResult result = { .found = false };
+     SearchWorkspace* ws = search_workspace_create(get_node_count(graph));
+     if (!ws) return result;
+     result = td_dijkstra_shortest_path_ws(graph, profiles, ws, start_id, end_id, departure_time, arrival_time);
+     search_workspace_destroy(ws);
+     return result;
+ }
+
+ PathResult td_a_star_shortest_path(const Graph* graph, const TimeProfiles* profiles, int start_id, int end_id,
+                                    double departure_time, double* arrival_time) {
+     PathResult result = { .found = false };
+     SearchWorkspace* ws = search_workspace_create(get_node_count(graph));
+     if (!ws) return result;
+     result = td_a_star_shortest_path_ws(graph, profiles, ws, start_id, end_id, departure_time, arrival_time);
+     search_workspace_destroy(ws);
+     return result;
+ }
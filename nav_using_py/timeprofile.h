@@ -0,0 +1,73 @@
+/*
+ * Time Profiles - Time-of-day travel times and time-dependent routing.
+ */
+
+ #ifndef TIMEPROFILE_H
+ #define TIMEPROFILE_H
+
+ #include "graph.h"
+ #include "algorithms.h"
+
+ #define TIME_PROFILE_DAY_SECONDS 86400.0
+ #define TIME_PROFILE_WALKING_SPEED_KMH 5.0   // Travel time of an edge at factor 1
+ #define TIME_PROFILE_MAX_ID 65535            // Profile ids are stored in 16 bits per edge
+
+ // A travel-time factor at a time of day; factors are linear between points
+ // and wrap around midnight
+ typedef struct {
+     float time;              // Seconds since midnight
+     float factor;
+ } ProfilePoint;
+
+ typedef struct {
+     int first_point;         // Index into TimeProfiles.points
+     int num_points;          // 0 for the flat profile (factor 1 all day)
+     float min_slope;         // Steepest fall of the factor per second, 0 if it never falls
+ } TravelProfile;
+
+ // Profiles are shared: every edge stores only the 16-bit id of its profile.
+ // Ids follow the graph's frozen CSR edge order, so the set must be reloaded
+ // after nodes or edges are added. Live weight updates and closures apply.
+ typedef struct {
+     int num_nodes;
+     int num_edges;
+     double seconds_per_km;   // Travel time of one km at factor 1
+     double min_factor;       // Smallest factor of any profile, for the A* bound
+
+     int num_profiles;        // Ids 0 .. num_profiles - 1; id 0 is flat
+     TravelProfile* profiles;
+     int num_points;
+     ProfilePoint* points;
+     uint16_t* edge_profiles; // [CSR edge index] = profile id
+ } TimeProfiles;
+
+ // Reads the optional profile section of a text map, or of a file holding only
+ // that section (so binary maps can have profiles too):
+ //     profile [id] [HH:MM] [factor] [HH:MM] [factor] ...
+ //     edge_profile [source_node_id] [destination_node_id] [id]
+ // Ids run from 1 to TIME_PROFILE_MAX_ID, and an edge_profile line covers both
+ // directions, as map edges do. Other lines are ignored and malformed ones are
+ // reported and skipped. Edges without a profile keep factor 1.
+ TimeProfiles* time_profiles_load(const Graph* graph, const char* filename);
+ void time_profiles_destroy(TimeProfiles* profiles);
+
+ // Earliest arrival over CSR edge edge_index when reaching its source at
+ // departure_time (seconds; may run past one day). Waiting at the source is
+ // allowed, so where a factor falls faster than time passes the arrival is
+ // that of waiting for the drop, and arrivals never decrease with departure
+ // time (FIFO).
+ double time_profiles_arrival(const TimeProfiles* profiles, const Graph* graph, int edge_index, double departure_time);
+
+ // Earliest-arrival routes leaving start_id at departure_time. total_distance
+ // is the route's length in km; arrival_time, if given, receives the arrival
+ // in seconds (DBL_MAX when there is no route).
+ PathResult td_dijkstra_shortest_path(const Graph* graph, const TimeProfiles* profiles, int start_id, int end_id,
+                                      double departure_time, double* arrival_time);
+ PathResult td_a_star_shortest_path(const Graph* graph, const TimeProfiles* profiles, int start_id, int end_id,
+                                    double departure_time, double* arrival_time);
+ PathResult td_dijkstra_shortest_path_ws(const Graph* graph, const TimeProfiles* profiles, SearchWorkspace* workspace,
+                                         int start_id, int end_id, double departure_time, double* arrival_time);
+ PathResult td_a_star_shortest_path_ws(const Graph* graph, const TimeProfiles* profiles, SearchWorkspace* workspace,
+                                       int start_id, int end_id, double departure_time, double* arrival_time);
+
+ #endif // TIMEPROFILE_H